@@ -0,0 +1,40 @@
+# SCHEMA_GEN
+# GENERATOR
+# SIZE
+# WORK_DIR
+# EXTRA_ARGS
+
+if (("${SCHEMA_GEN}" STREQUAL "") OR ("${GENERATOR}" STREQUAL "") OR ("${SIZE}" STREQUAL "") OR ("${WORK_DIR}" STREQUAL ""))
+    message (FATAL_ERROR "Bad benchmark parameters")
+endif ()
+
+set (schema "${WORK_DIR}/bench${SIZE}.xml")
+set (output_dir "${WORK_DIR}/bench${SIZE}")
+set (trace_file "${WORK_DIR}/bench${SIZE}.json")
+
+execute_process (
+    COMMAND ${SCHEMA_GEN} ${SIZE} ${schema}
+    RESULT_VARIABLE gen_result
+)
+
+if (NOT "${gen_result}" STREQUAL "0")
+    message (FATAL_ERROR "Failed to synthesize schema with ${SIZE} messages")
+endif ()
+
+file (REMOVE_RECURSE "${output_dir}")
+
+message (STATUS "Benchmarking ${SIZE} messages (${schema})")
+execute_process (
+    COMMAND ${GENERATOR} -o ${output_dir} --stats --trace-file ${trace_file} ${EXTRA_ARGS} ${schema}
+    RESULT_VARIABLE bench_result
+    OUTPUT_VARIABLE bench_output
+)
+
+# Report only the statistics, not every generated file
+string (REGEX REPLACE "INFO: Generating [^\n]*\n" "" bench_output "${bench_output}")
+message ("${bench_output}")
+message (STATUS "Trace events are written to ${trace_file}")
+
+if (NOT "${bench_result}" STREQUAL "0")
+    message (FATAL_ERROR "Code generation for ${SIZE} messages has failed")
+endif ()
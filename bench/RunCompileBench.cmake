@@ -0,0 +1,77 @@
+# SCHEMA_GEN
+# GENERATOR
+# SIZE
+# WORK_DIR
+# CXX_COMPILER
+# COMMS_INCLUDE_DIR
+
+if (("${SCHEMA_GEN}" STREQUAL "") OR ("${GENERATOR}" STREQUAL "") OR ("${SIZE}" STREQUAL "") OR
+    ("${WORK_DIR}" STREQUAL "") OR ("${CXX_COMPILER}" STREQUAL "") OR ("${COMMS_INCLUDE_DIR}" STREQUAL ""))
+    message (FATAL_ERROR "Bad benchmark parameters")
+endif ()
+
+set (schema "${WORK_DIR}/bench${SIZE}.xml")
+set (output_dir "${WORK_DIR}/bench${SIZE}_compile")
+set (ns "bench${SIZE}")
+
+execute_process (
+    COMMAND ${SCHEMA_GEN} ${SIZE} ${schema}
+    RESULT_VARIABLE gen_result
+)
+
+if (NOT "${gen_result}" STREQUAL "0")
+    message (FATAL_ERROR "Failed to synthesize schema with ${SIZE} messages")
+endif ()
+
+file (REMOVE_RECURSE "${output_dir}")
+execute_process (
+    COMMAND ${GENERATOR} -o ${output_dir} --components=protocol ${schema}
+    RESULT_VARIABLE gen_result
+    OUTPUT_QUIET
+)
+
+if (NOT "${gen_result}" STREQUAL "0")
+    message (FATAL_ERROR "Code generation for ${SIZE} messages has failed")
+endif ()
+
+# The same program creating a message with the type list iterating
+# comms::MsgFactory and with the generated switch based MsgFactory.
+set (interface "${ns}::Message<comms::option::ReadIterator<const std::uint8_t*>, comms::option::IdInfoInterface>")
+set (tuple_factory "comms::MsgFactory<Interface, ${ns}::AllMessages<Interface> >")
+set (switch_factory "${ns}::MsgFactory<Interface>")
+
+message (STATUS "Compiling message factories of ${SIZE} messages")
+foreach (kind tuple switch)
+    set (src "${output_dir}/${kind}_factory.cpp")
+    file (WRITE "${src}"
+        "#include \"comms/MsgFactory.h\"\n"
+        "#include \"${ns}/MsgFactory.h\"\n\n"
+        "using Interface = ${interface};\n"
+        "using Factory = ${${kind}_factory};\n\n"
+        "int main()\n"
+        "{\n"
+        "    Factory factory;\n"
+        "    return factory.createMsg(static_cast<${ns}::MsgId>(1)) ? 0 : 1;\n"
+        "}\n"
+    )
+
+    string (TIMESTAMP start "%s" UTC)
+    execute_process (
+        COMMAND ${CXX_COMPILER} -std=c++11 -ftemplate-depth=1024 -c
+            -I${output_dir}/include -I${COMMS_INCLUDE_DIR}
+            -o "${output_dir}/${kind}_factory.o" "${src}"
+        RESULT_VARIABLE compile_result
+        OUTPUT_QUIET
+        ERROR_VARIABLE compile_errors
+    )
+    string (TIMESTAMP finish "%s" UTC)
+    math (EXPR elapsed "${finish} - ${start}")
+
+    if ("${compile_result}" STREQUAL "0")
+        message ("    ${kind} factory: ${elapsed} s")
+    else ()
+        # The type list factory is expected to fail on big schemas
+        string (REGEX MATCH "[^\n]*error[^\n]*" first_error "${compile_errors}")
+        message ("    ${kind} factory: failed after ${elapsed} s: ${first_error}")
+    endif ()
+endforeach ()
@@ -0,0 +1,153 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// Synthesizes SBE schemas of arbitrary size to benchmark the generator.
+// Every message uses types from one of the type "families", where each
+// family consists of an enum, a set and a chain of nested composites.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+namespace
+{
+
+const unsigned CompositeDepth = 4U;
+const unsigned MessagesPerFamily = 4U;
+
+void writeHeader(std::ostream& out, unsigned messagesCount)
+{
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+           "<messageSchema package=\"bench" << messagesCount << "\"\n"
+           "               id=\"1\"\n"
+           "               semanticVersion=\"5.2\"\n"
+           "               description=\"Synthetic schema with " << messagesCount << " messages\"\n"
+           "               byteOrder=\"littleEndian\">\n";
+}
+
+void writeCommonTypes(std::ostream& out)
+{
+    out << "        <composite name=\"messageHeader\">\n"
+           "            <type name=\"blockLength\" primitiveType=\"uint16\"/>\n"
+           "            <type name=\"templateId\" primitiveType=\"uint16\"/>\n"
+           "            <type name=\"schemaId\" primitiveType=\"uint16\"/>\n"
+           "            <type name=\"version\" primitiveType=\"uint16\"/>\n"
+           "        </composite>\n"
+           "        <composite name=\"groupSizeEncoding\">\n"
+           "            <type name=\"blockLength\" primitiveType=\"uint16\"/>\n"
+           "            <type name=\"numInGroup\" primitiveType=\"uint16\"/>\n"
+           "        </composite>\n"
+           "        <composite name=\"varDataEncoding\">\n"
+           "            <type name=\"length\" primitiveType=\"uint16\"/>\n"
+           "            <type name=\"varData\" primitiveType=\"uint8\" length=\"0\"/>\n"
+           "        </composite>\n";
+}
+
+void writeFamily(std::ostream& out, unsigned idx)
+{
+    auto suffix = std::to_string(idx);
+    out << "        <enum name=\"Enum" << suffix << "\" encodingType=\"uint8\">\n";
+    for (unsigned v = 0U; v < 4U; ++v) {
+        out << "            <validValue name=\"Val" << v << "\">" << v << "</validValue>\n";
+    }
+    out << "        </enum>\n";
+
+    out << "        <set name=\"Set" << suffix << "\" encodingType=\"uint16\">\n";
+    for (unsigned b = 0U; b < 4U; ++b) {
+        out << "            <choice name=\"bit" << b * 3 << "\">" << b * 3 << "</choice>\n";
+    }
+    out << "        </set>\n";
+
+    for (unsigned d = 0U; d < CompositeDepth; ++d) {
+        out << "        <composite name=\"Comp" << suffix << '_' << d << "\">\n"
+               "            <type name=\"mem1\" primitiveType=\"uint32\"/>\n"
+               "            <ref name=\"mem2\" type=\"Enum" << suffix << "\"/>\n"
+               "            <type name=\"mem3\" primitiveType=\"int16\" offset=\"8\"/>\n";
+        if ((d + 1) < CompositeDepth) {
+            out << "            <ref name=\"mem4\" type=\"Comp" << suffix << '_' << (d + 1) << "\"/>\n";
+        }
+        out << "        </composite>\n";
+    }
+}
+
+void writeMessage(std::ostream& out, unsigned idx, unsigned family)
+{
+    auto suffix = std::to_string(family);
+    out << "    <message name=\"Msg" << idx << "\" id=\"" << idx << "\">\n"
+           "        <field name=\"field1\" id=\"1\" type=\"uint32\"/>\n"
+           "        <field name=\"field2\" id=\"2\" type=\"Enum" << suffix << "\"/>\n"
+           "        <field name=\"field3\" id=\"3\" type=\"Set" << suffix << "\" offset=\"8\"/>\n"
+           "        <field name=\"field4\" id=\"4\" type=\"Comp" << suffix << "_0\"/>\n"
+           "        <group name=\"group1\" id=\"5\">\n"
+           "            <field name=\"mem1\" id=\"51\" type=\"uint16\"/>\n"
+           "            <field name=\"mem2\" id=\"52\" type=\"Enum" << suffix << "\"/>\n"
+           "            <field name=\"mem3\" id=\"53\" type=\"Comp" << suffix << '_' << (CompositeDepth - 1) << "\" offset=\"4\"/>\n"
+           "            <group name=\"group2\" id=\"54\">\n"
+           "                <field name=\"mem1\" id=\"541\" type=\"int64\"/>\n"
+           "                <field name=\"mem2\" id=\"542\" type=\"Set" << suffix << "\"/>\n"
+           "                <data name=\"mem3\" id=\"543\" type=\"varDataEncoding\"/>\n"
+           "            </group>\n"
+           "        </group>\n"
+           "        <data name=\"data1\" id=\"6\" type=\"varDataEncoding\"/>\n"
+           "    </message>\n";
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage:\n\t" << argv[0] << " messages_count output_file\n";
+        return -1;
+    }
+
+    auto messagesCount = static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10));
+    if (messagesCount == 0U) {
+        std::cerr << "ERROR: Invalid messages count: " << argv[1] << std::endl;
+        return -1;
+    }
+
+    std::ofstream out(argv[2]);
+    if (!out) {
+        std::cerr << "ERROR: Failed to create " << argv[2] << std::endl;
+        return -1;
+    }
+
+    auto familiesCount = (messagesCount + MessagesPerFamily - 1) / MessagesPerFamily;
+    writeHeader(out, messagesCount);
+    out << "    <types>\n";
+    writeCommonTypes(out);
+    for (unsigned f = 0U; f < familiesCount; ++f) {
+        writeFamily(out, f);
+    }
+    out << "    </types>\n";
+
+    for (unsigned m = 0U; m < messagesCount; ++m) {
+        writeMessage(out, m + 1, m % familiesCount);
+    }
+    out << "</messageSchema>\n";
+
+    out.flush();
+    if (!out.good()) {
+        std::cerr << "ERROR: The file " << argv[2] << " hasn't been written properly!" << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -17,12 +17,12 @@
 
 #include "AllFields.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -57,14 +57,10 @@ bool AllFields::write()
 
 bool AllFields::writePluginHeader()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::fieldHeaderFileName();
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -83,19 +79,15 @@ bool AllFields::writePluginHeader()
 
     out << '\n';
     closeNamespaces(out, m_db);
-    return true;
+    return out.commit();
 }
 
 bool AllFields::writePluginDef()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::fieldDefFileName();
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -124,7 +116,7 @@ bool AllFields::writePluginDef()
     }
 
     closeNamespaces(out, m_db);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
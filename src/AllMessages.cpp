@@ -17,12 +17,12 @@
 
 #include "AllMessages.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -33,19 +33,23 @@ namespace sbe2comms
 
 bool AllMessages::write()
 {
-    return writeProtocolDef() && writePluginDef();
+    if (!writeProtocolDef()) {
+        return false;
+    }
+
+    if (!m_db.isComponentEnabled(DB::Component::Plugin)) {
+        return true;
+    }
+
+    return writePluginDef();
 }
 
 bool AllMessages::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(m_db.getProtocolNamespace(), common::allMessagesFileName());
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -87,19 +91,15 @@ bool AllMessages::writeProtocolDef()
     }
     out << ">;\n\n";
     common::writeProtocolNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 bool AllMessages::writePluginDef()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::allMessagesFileName();
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -132,7 +132,7 @@ bool AllMessages::writePluginDef()
     out << output::indent(1) << ">;\n\n";
 
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 
@@ -36,6 +36,16 @@ public:
         m_generatedPadding = true;
     }
 
+    bool isGeneratedPadding() const
+    {
+        return m_generatedPadding;
+    }
+
+    const Type* getReferencedType() const
+    {
+        return m_type;
+    }
+
 protected:
     virtual Kind getKindImpl() const override;
     virtual unsigned getReferencedTypeSinceVersionImpl() const override;
@@ -18,7 +18,6 @@
 #include "BuiltIn.h"
 
 #include <iostream>
-#include <fstream>
 #include <algorithm>
 
 #include <boost/filesystem.hpp>
@@ -28,6 +27,7 @@
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 
 namespace bf = boost::filesystem;
 namespace ba = boost::algorithm;
@@ -167,14 +167,10 @@ void writeBuiltInFloat(DB& db, std::ostream& out, const std::string& name)
 
 bool writeBuiltIn(DB& db, const std::string& name)
 {
-    if (!common::createProtocolDefDir(db.getRootPath(), db.getProtocolNamespace(), common::builtinNamespaceNameStr())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + name + ".h");
     auto filePath = bf::path(db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -188,22 +184,18 @@ bool writeBuiltIn(DB& db, const std::string& name)
     auto iter = std::find(std::begin(FloatTypes), std::end(FloatTypes), name);
     if (iter != std::end(FloatTypes)) {
         writeBuiltInFloat(db, out, name);
-        return out.good();
+        return out.commit();
     }
     writeBuiltInInt(db, out, name);
-    return out.good();
+    return out.commit();
 }
 
 bool writeGroupList(DB& db)
 {
-    if (!common::createProtocolDefDir(db.getRootPath(), db.getProtocolNamespace(), common::builtinNamespaceNameStr())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::groupListStr() + ".h");
     auto filePath = bf::path(db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -214,6 +206,7 @@ bool writeGroupList(DB& db)
            "/// \\brief Contains definition of implicitly defined \\ref " << common::scopeFor(ns, common::builtinNamespaceStr() + common::groupListStr()) << "\n"
            "\n\n"
            "#pragma once\n\n"
+           "#include <algorithm>\n"
            "#include <cstdint>\n"
            "#include <type_traits>\n\n"
            "#include \"comms/Field.h\"\n"
@@ -221,7 +214,8 @@ bool writeGroupList(DB& db)
            "#include \"comms/field/Optional.h\"\n"
            "#include \"comms/options.h\"\n"
            "#include \"comms/util/Tuple.h\"\n\n"
-           "#include \"VersionSetter.h\"\n\n";
+           "#include \"VersionSetter.h\"\n"
+           "#include \"" << common::projectionFileName() << "\"\n\n";
     writeNamespaceBegin(out, ns);
     out << "/// \\brief Generic list type to be used to defaine a \"group\" list.\n"
            "/// \\tparam TFieldBase Common base class of all the fields.\n"
@@ -251,6 +245,9 @@ bool writeGroupList(DB& db)
            output::indent(2) << "return TDimensionType::maxLength() + Base::length();\n" <<
            output::indent(1) << "}\n\n" <<
            output::indent(1) << "/// \\brief Read field value from input data sequence.\n" <<
+           output::indent(1) << "/// \\details The elements already stored in the list are reused, the storage\n" <<
+           output::indent(1) << "///     capacity is preserved, so repeated reads of the same list don't\n" <<
+           output::indent(1) << "///     allocate once the capacity is sufficient.\n" <<
            output::indent(1) << "template <typename TIter>\n" <<
            output::indent(1) << "comms::ErrorStatus read(TIter& iter, std::size_t len)\n" <<
            output::indent(1) << "{\n" <<
@@ -261,6 +258,9 @@ bool writeGroupList(DB& db)
            output::indent(2) << "}\n\n" <<
            output::indent(2) << "auto count = dimType.field_numInGroup().value();\n" <<
            output::indent(2) << "auto remLen = len - dimType.length();\n" <<
+           output::indent(2) << "if (!reserveElements(static_cast<std::size_t>(count), static_cast<std::size_t>(dimType.field_blockLength().value()), remLen)) {\n" <<
+           output::indent(3) << "return comms::ErrorStatus::InvalidMsgData;\n" <<
+           output::indent(2) << "}\n\n" <<
            output::indent(2) << "for (decltype(count) idx = 0; idx < count; ++idx) {\n" <<
            output::indent(3) << "using IterType = typename std::decay<decltype(iter)>::type;\n" <<
            output::indent(3) << "using IterCategory = typename std::iterator_traits<IterType>::iterator_category;\n" <<
@@ -271,26 +271,76 @@ bool writeGroupList(DB& db)
            output::indent(3) << "IterType iterTmp(iter);\n" <<
            output::indent(3) << "auto blockLength = static_cast<std::size_t>(dimType.field_blockLength().value());\n" <<
            output::indent(3) << "if (remLen < blockLength) {\n" <<
+           output::indent(4) << "dropElements(static_cast<std::size_t>(idx));\n" <<
+           output::indent(4) << "return comms::ErrorStatus::NotEnoughData;\n" <<
+           output::indent(3) << "}\n\n" <<
+           output::indent(3) << "auto& elem = elementAt(static_cast<std::size_t>(idx));\n" <<
+           output::indent(3) << "comms::util::tupleAccumulate(elem.value(), false, VersionSetter(m_version));\n" <<
+           output::indent(3) << "es = elem.template readUntil<TRootCount>(iterTmp, blockLength);\n" <<
+           output::indent(3) << "if (es != comms::ErrorStatus::Success) {\n" <<
+           output::indent(4) << "dropElements(static_cast<std::size_t>(idx));\n" <<
+           output::indent(4) << "return es;\n" <<
+           output::indent(3) << "}\n\n" <<
+           output::indent(3) << "std::advance(iter, blockLength);\n" <<
+           output::indent(3) << "remLen -= blockLength;\n\n" <<
+           output::indent(3) << "es = elem.template readFrom<TRootCount>(iter, remLen);\n" <<
+           output::indent(3) << "if (es != comms::ErrorStatus::Success) {\n" <<
+           output::indent(4) << "dropElements(static_cast<std::size_t>(idx));\n" <<
+           output::indent(4) << "return es;\n" <<
+           output::indent(3) << "}\n\n" <<
+           output::indent(3) << "remLen -= elem.template lengthFrom<TRootCount>();\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "dropElements(static_cast<std::size_t>(count));\n" <<
+           output::indent(2) << "return checkFailOnInvalid();\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Read only the selected root block members of every element.\n" <<
+           output::indent(1) << "/// \\details The other root block members are skipped using \\b blockLength\n" <<
+           output::indent(1) << "///     of the dimension type, while the groups and data fields of the\n" <<
+           output::indent(1) << "///     elements (if any) are read to find the end of every element.\n" <<
+           output::indent(1) << "/// \\tparam TIdx Indices of the selected members, expected to be less than \\b TRootCount.\n" <<
+           output::indent(1) << "template <std::size_t... TIdx, typename TIter>\n" <<
+           output::indent(1) << "comms::ErrorStatus readFields(TIter& iter, std::size_t len)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "static_assert(rootIndicesValid<TRootCount, TIdx...>(), \"Only root block members can be selected\");\n" <<
+           output::indent(2) << "using IterType = typename std::decay<decltype(iter)>::type;\n" <<
+           output::indent(2) << "using IterCategory = typename std::iterator_traits<IterType>::iterator_category;\n" <<
+           output::indent(2) << "static_assert(\n" <<
+           output::indent(3) << "std::is_copy_constructible<IterType>::value &&\n" <<
+           output::indent(3) << "std::is_base_of<std::forward_iterator_tag, IterCategory>::value,\n" <<
+           output::indent(3) << "\"Used iterator type is not supported for read operation\");\n" <<
+           output::indent(2) << "TDimensionType dimType;\n" <<
+           output::indent(2) << "auto es = dimType.read(iter, len);\n" <<
+           output::indent(2) << "if (es != comms::ErrorStatus::Success) {\n" <<
+           output::indent(3) << "return es;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "auto count = dimType.field_numInGroup().value();\n" <<
+           output::indent(2) << "auto blockLength = static_cast<std::size_t>(dimType.field_blockLength().value());\n" <<
+           output::indent(2) << "auto remLen = len - dimType.length();\n" <<
+           output::indent(2) << "if (!reserveElements(static_cast<std::size_t>(count), blockLength, remLen)) {\n" <<
+           output::indent(3) << "return comms::ErrorStatus::InvalidMsgData;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "for (decltype(count) idx = 0; idx < count; ++idx) {\n" <<
+           output::indent(3) << "if (remLen < blockLength) {\n" <<
+           output::indent(4) << "dropElements(static_cast<std::size_t>(idx));\n" <<
            output::indent(4) << "return comms::ErrorStatus::NotEnoughData;\n" <<
            output::indent(3) << "}\n\n" <<
-           output::indent(3) << common::fieldBaseDefStr() <<
-           output::indent(3) << "Base::value().emplace_back();\n" <<
-           output::indent(3) << "auto& lastElem = Base::value().back();\n" <<
-           output::indent(3) << "comms::util::tupleAccumulate(lastElem.value(), false, VersionSetter(m_version));\n" <<
-           output::indent(3) << "es = lastElem.template readUntil<TRootCount>(iterTmp, blockLength);\n" <<
+           output::indent(3) << "auto& elem = elementAt(static_cast<std::size_t>(idx));\n" <<
+           output::indent(3) << "comms::util::tupleAccumulate(elem.value(), false, VersionSetter(m_version));\n" <<
+           output::indent(3) << "es = readRootFields<TIdx...>(elem.value(), iter, blockLength);\n" <<
            output::indent(3) << "if (es != comms::ErrorStatus::Success) {\n" <<
-           output::indent(4) << "Base::value().pop_back();\n" <<
+           output::indent(4) << "dropElements(static_cast<std::size_t>(idx));\n" <<
            output::indent(4) << "return es;\n" <<
            output::indent(3) << "}\n\n" <<
            output::indent(3) << "std::advance(iter, blockLength);\n" <<
            output::indent(3) << "remLen -= blockLength;\n\n" <<
-           output::indent(3) << "es = lastElem.template readFrom<TRootCount>(iter, remLen);\n" <<
+           output::indent(3) << "es = elem.template readFrom<TRootCount>(iter, remLen);\n" <<
            output::indent(3) << "if (es != comms::ErrorStatus::Success) {\n" <<
-           output::indent(4) << "Base::value().pop_back();\n" <<
+           output::indent(4) << "dropElements(static_cast<std::size_t>(idx));\n" <<
            output::indent(4) << "return es;\n" <<
            output::indent(3) << "}\n\n" <<
-           output::indent(3) << "remLen -= Base::value().back().template lengthFrom<TRootCount>();\n" <<
+           output::indent(3) << "remLen -= elem.template lengthFrom<TRootCount>();\n" <<
            output::indent(2) << "}\n\n" <<
+           output::indent(2) << "dropElements(static_cast<std::size_t>(count));\n" <<
            output::indent(2) << "return checkFailOnInvalid();\n" <<
            output::indent(1) << "}\n\n" <<
            output::indent(1) << "/// \\brief Read field value from input data sequence without error check and status report.\n" <<
@@ -376,22 +426,155 @@ bool writeGroupList(DB& db)
            output::indent(2) << "}\n\n" <<
            output::indent(2) << "return comms::ErrorStatus::Success;\n" <<
            output::indent(1) << "}\n\n" <<
+           output::indent(1) << "bool reserveElements(std::size_t count, std::size_t blockLength, std::size_t remLen)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << common::fieldBaseDefStr() <<
+           output::indent(2) << "auto& list = Base::value();\n" <<
+           output::indent(2) << "if (list.max_size() < count) {\n" <<
+           output::indent(3) << "return false;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "// Every element occupies at least its block, don't trust hostile numInGroup\n" <<
+           output::indent(2) << "if (blockLength == 0U) {\n" <<
+           output::indent(3) << "return true;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "auto reserveCount = std::min(count, remLen / blockLength);\n" <<
+           output::indent(2) << "if (list.capacity() < reserveCount) {\n" <<
+           output::indent(3) << "list.reserve(reserveCount);\n" <<
+           output::indent(2) << "}\n" <<
+           output::indent(2) << "return true;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "TElement& elementAt(std::size_t idx)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << common::fieldBaseDefStr() <<
+           output::indent(2) << "auto& list = Base::value();\n" <<
+           output::indent(2) << "if (idx < list.size()) {\n" <<
+           output::indent(3) << "return list[idx];\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "list.emplace_back();\n" <<
+           output::indent(2) << "return list.back();\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "void dropElements(std::size_t count)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << common::fieldBaseDefStr() <<
+           output::indent(2) << "auto& list = Base::value();\n" <<
+           output::indent(2) << "if (count < list.size()) {\n" <<
+           output::indent(3) << "list.erase(list.begin() + count, list.end());\n" <<
+           output::indent(2) << "}\n" <<
+           output::indent(1) << "}\n\n" <<
            output::indent(1) << "unsigned m_version = " << db.getSchemaVersion() << ";\n"
            "};\n\n";
     writeNamespaceEnd(out, ns);
-    return out.good();
+    return out.commit();
 }
 
-bool writeOpenFrameHeader(DB& db)
+bool writeProjection(DB& db)
 {
-    if (!common::createProtocolDefDir(db.getRootPath(), db.getProtocolNamespace(), common::builtinNamespaceNameStr())) {
+    auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::projectionFileName());
+    auto filePath = bf::path(db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
     }
 
+    auto& ns = db.getProtocolNamespace();
+    out << "/// \\file\n"
+           "/// \\brief Contains helper functions used to read only the selected root block fields.\n"
+           "\n\n"
+           "#pragma once\n\n"
+           "#include <cstddef>\n"
+           "#include <iterator>\n"
+           "#include <tuple>\n\n"
+           "#include \"comms/ErrorStatus.h\"\n\n";
+    writeNamespaceBegin(out, ns);
+    out << "namespace details\n"
+           "{\n\n"
+           "template <typename TFields, std::size_t TIdx>\n"
+           "struct RootFieldOffset\n"
+           "{\n" <<
+           output::indent(1) << "static constexpr std::size_t value()\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return\n" <<
+           output::indent(3) << "RootFieldOffset<TFields, TIdx - 1>::value() +\n" <<
+           output::indent(3) << "std::tuple_element<TIdx - 1, TFields>::type::maxLength();\n" <<
+           output::indent(1) << "}\n"
+           "};\n\n"
+           "template <typename TFields>\n"
+           "struct RootFieldOffset<TFields, 0U>\n"
+           "{\n" <<
+           output::indent(1) << "static constexpr std::size_t value()\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return 0U;\n" <<
+           output::indent(1) << "}\n"
+           "};\n\n"
+           "template <std::size_t... TIdx>\n"
+           "struct RootFieldsReader;\n\n"
+           "template <>\n"
+           "struct RootFieldsReader<>\n"
+           "{\n" <<
+           output::indent(1) << "template <typename TFields, typename TIter>\n" <<
+           output::indent(1) << "static comms::ErrorStatus read(TFields&, const TIter&, std::size_t)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return comms::ErrorStatus::Success;\n" <<
+           output::indent(1) << "}\n"
+           "};\n\n"
+           "template <std::size_t TIdx, std::size_t... TRest>\n"
+           "struct RootFieldsReader<TIdx, TRest...>\n"
+           "{\n" <<
+           output::indent(1) << "template <typename TFields, typename TIter>\n" <<
+           output::indent(1) << "static comms::ErrorStatus read(TFields& fields, const TIter& iter, std::size_t blockLength)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "auto offset = RootFieldOffset<TFields, TIdx>::value();\n" <<
+           output::indent(2) << "auto& field = std::get<TIdx>(fields);\n" <<
+           output::indent(2) << "// The fields beyond the block are not known to the sender\n" <<
+           output::indent(2) << "if ((offset + field.length()) <= blockLength) {\n" <<
+           output::indent(3) << "auto fieldIter = iter;\n" <<
+           output::indent(3) << "std::advance(fieldIter, offset);\n" <<
+           output::indent(3) << "auto es = field.read(fieldIter, blockLength - offset);\n" <<
+           output::indent(3) << "if (es != comms::ErrorStatus::Success) {\n" <<
+           output::indent(4) << "return es;\n" <<
+           output::indent(3) << "}\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "return RootFieldsReader<TRest...>::read(fields, iter, blockLength);\n" <<
+           output::indent(1) << "}\n"
+           "};\n\n"
+           "} // namespace details\n\n"
+           "/// \\brief Check all the indices are less than \\b TLimit.\n"
+           "template <std::size_t TLimit>\n"
+           "constexpr bool rootIndicesValid()\n"
+           "{\n" <<
+           output::indent(1) << "return true;\n"
+           "}\n\n"
+           "/// \\brief Check all the indices are less than \\b TLimit.\n"
+           "template <std::size_t TLimit, std::size_t TIdx, std::size_t... TRest>\n"
+           "constexpr bool rootIndicesValid()\n"
+           "{\n" <<
+           output::indent(1) << "return (TIdx < TLimit) && rootIndicesValid<TLimit, TRest...>();\n"
+           "}\n\n"
+           "/// \\brief Read only the selected fields of the root block.\n"
+           "/// \\details Every selected field is decoded at its offset, calculated as a sum\n"
+           "///     of the lengths of the preceding fields, the other fields are left intact.\n"
+           "///     The fields, which don't fit into the \\b blockLength, are not read.\n"
+           "/// \\tparam TIdx Indices of the selected fields.\n"
+           "/// \\param[in, out] fields Tuple of the fixed length fields, which starts the block.\n"
+           "/// \\param[in] iter Iterator to the beginning of the block, not advanced.\n"
+           "/// \\param[in] blockLength Length of the block.\n"
+           "template <std::size_t... TIdx, typename TFields, typename TIter>\n"
+           "comms::ErrorStatus readRootFields(TFields& fields, const TIter& iter, std::size_t blockLength)\n"
+           "{\n" <<
+           output::indent(1) << "return details::RootFieldsReader<TIdx...>::read(fields, iter, blockLength);\n"
+           "}\n\n";
+    writeNamespaceEnd(out, ns);
+    return out.commit();
+}
+
+bool writeOpenFrameHeader(DB& db)
+{
     auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::openFramingHeaderStr() + ".h");
     auto filePath = bf::path(db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -457,19 +640,15 @@ bool writeOpenFrameHeader(DB& db)
            output::indent(1) << ");\n"
            "};\n\n";
     writeNamespaceEnd(out, ns);
-    return out.good();
+    return out.commit();
 }
 
 bool writePad(DB& db)
 {
-    if (!common::createProtocolDefDir(db.getRootPath(), db.getProtocolNamespace(), common::builtinNamespaceNameStr())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::padStr() + ".h");
     auto filePath = bf::path(db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -506,19 +685,15 @@ bool writePad(DB& db)
     common::writeDefaultSetVersionFunc(out, 1);
     out << "};\n\n";
     writeNamespaceEnd(out, ns);
-    return out.good();
+    return out.commit();
 }
 
 bool writeVersionSetter(DB& db)
 {
-    if (!common::createProtocolDefDir(db.getRootPath(), db.getProtocolNamespace(), common::builtinNamespaceNameStr())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::versionSetterFileName());
     auto filePath = bf::path(db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -545,7 +720,481 @@ bool writeVersionSetter(DB& db)
            output::indent(1) << "unsigned m_version = 0U;\n"
            "};\n\n";
     writeNamespaceEnd(out, ns);
-    return out.good();
+    return out.commit();
+}
+
+bool writeView(DB& db)
+{
+    auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::viewFileName());
+    auto filePath = bf::path(db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    auto& ns = db.getProtocolNamespace();
+    out << "/// \\file\n"
+           "/// \\brief Contains helper classes and functions used by the generated message views.\n"
+           "\n\n"
+           "#pragma once\n\n"
+           "#include <cstdint>\n"
+           "#include <cstddef>\n"
+           "#include <cstring>\n"
+           "#include <iterator>\n"
+           "#include <type_traits>\n\n"
+           "#include \"comms/util/access.h\"\n\n";
+    writeNamespaceBegin(out, ns);
+    out << "namespace details\n"
+           "{\n\n"
+           "template <typename T, typename TEndian>\n"
+           "T viewRead(const std::uint8_t* buf, std::false_type)\n"
+           "{\n" <<
+           output::indent(1) << "return comms::util::readData<T>(buf, TEndian());\n"
+           "}\n\n"
+           "template <typename T, typename TEndian>\n"
+           "T viewRead(const std::uint8_t* buf, std::true_type)\n"
+           "{\n" <<
+           output::indent(1) << "using IntType =\n" <<
+           output::indent(2) << "typename std::conditional<\n" <<
+           output::indent(3) << "sizeof(T) == sizeof(std::uint32_t),\n" <<
+           output::indent(3) << "std::uint32_t,\n" <<
+           output::indent(3) << "std::uint64_t\n" <<
+           output::indent(2) << ">::type;\n" <<
+           output::indent(1) << "auto intVal = comms::util::readData<IntType>(buf, TEndian());\n" <<
+           output::indent(1) << "T val;\n" <<
+           output::indent(1) << "std::memcpy(&val, &intVal, sizeof(val));\n" <<
+           output::indent(1) << "return val;\n"
+           "}\n\n"
+           "} // namespace details\n\n"
+           "/// \\brief Read single value from the raw buffer.\n"
+           "/// \\tparam T Type of the value.\n"
+           "/// \\tparam TEndian Endianness tag of the schema.\n"
+           "template <typename T, typename TEndian>\n"
+           "T viewRead(const std::uint8_t* buf)\n"
+           "{\n" <<
+           output::indent(1) << "return details::viewRead<T, TEndian>(buf, std::is_floating_point<T>());\n"
+           "}\n\n"
+           "/// \\brief View of the raw bytes of the \"data\" field.\n";
+    writeHeaderfileInfo(out, ns, common::viewStr());
+    out << "class DataView\n"
+           "{\n"
+           "public:\n" <<
+           output::indent(1) << "/// \\brief Default constructor, creates empty view.\n" <<
+           output::indent(1) << "DataView() = default;\n\n" <<
+           output::indent(1) << "/// \\brief Constructor.\n" <<
+           output::indent(1) << "DataView(const std::uint8_t* buf, std::size_t len) : m_buf(buf), m_len(len) {}\n\n" <<
+           output::indent(1) << "/// \\brief Pointer to the first byte.\n" <<
+           output::indent(1) << "const std::uint8_t* data() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_buf;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Number of bytes.\n" <<
+           output::indent(1) << "std::size_t size() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_len;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Check the view is empty.\n" <<
+           output::indent(1) << "bool empty() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_len == 0U;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Iterator to the first byte.\n" <<
+           output::indent(1) << "const std::uint8_t* begin() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_buf;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Iterator past the last byte.\n" <<
+           output::indent(1) << "const std::uint8_t* end() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_buf + m_len;\n" <<
+           output::indent(1) << "}\n\n"
+           "private:\n" <<
+           output::indent(1) << "const std::uint8_t* m_buf = nullptr;\n" <<
+           output::indent(1) << "std::size_t m_len = 0U;\n"
+           "};\n\n"
+           "/// \\brief Create view of the \"data\" field.\n"
+           "/// \\tparam TLen Type of the length prefix.\n"
+           "/// \\tparam TEndian Endianness tag of the schema.\n"
+           "template <typename TLen, typename TEndian>\n"
+           "DataView viewData(const std::uint8_t* buf)\n"
+           "{\n" <<
+           output::indent(1) << "auto len = static_cast<std::size_t>(viewRead<TLen, TEndian>(buf));\n" <<
+           output::indent(1) << "return DataView(buf + sizeof(TLen), len);\n"
+           "}\n\n"
+           "/// \\brief Get position following the \"data\" field.\n"
+           "/// \\details Returns \\b nullptr if the field exceeds \\b end, the bounds\n"
+           "///     are not checked when \\b end is \\b nullptr.\n"
+           "template <typename TLen, typename TEndian>\n"
+           "const std::uint8_t* viewSkipData(const std::uint8_t* buf, const std::uint8_t* end)\n"
+           "{\n" <<
+           output::indent(1) << "if ((end != nullptr) && (static_cast<std::size_t>(end - buf) < sizeof(TLen))) {\n" <<
+           output::indent(2) << "return nullptr;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "auto len = static_cast<std::size_t>(viewRead<TLen, TEndian>(buf));\n" <<
+           output::indent(1) << "auto* iter = buf + sizeof(TLen);\n" <<
+           output::indent(1) << "if ((end != nullptr) && (static_cast<std::size_t>(end - iter) < len)) {\n" <<
+           output::indent(2) << "return nullptr;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "return iter + len;\n"
+           "}\n\n"
+           "/// \\brief Get position following the \"group\" list.\n"
+           "/// \\details Returns \\b nullptr if the list exceeds \\b end or its elements\n"
+           "///     are too short, the bounds are not checked when \\b end is \\b nullptr.\n"
+           "/// \\tparam TElement View of the single element of the list.\n"
+           "template <typename TElement>\n"
+           "const std::uint8_t* viewSkipGroup(const std::uint8_t* buf, const std::uint8_t* end, unsigned version)\n"
+           "{\n" <<
+           output::indent(1) << "if ((end != nullptr) && (static_cast<std::size_t>(end - buf) < TElement::dimensionLength())) {\n" <<
+           output::indent(2) << "return nullptr;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "auto blockLength = TElement::readBlockLength(buf);\n" <<
+           output::indent(1) << "auto count = TElement::readNumInGroup(buf);\n" <<
+           output::indent(1) << "if ((end != nullptr) && (blockLength < TElement::minBlockLength())) {\n" <<
+           output::indent(2) << "return nullptr;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "auto* iter = buf + TElement::dimensionLength();\n" <<
+           output::indent(1) << "if (TElement::hasFixedLength()) {\n" <<
+           output::indent(2) << "auto len = blockLength * count;\n" <<
+           output::indent(2) << "if ((end != nullptr) && (static_cast<std::size_t>(end - iter) < len)) {\n" <<
+           output::indent(3) << "return nullptr;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "return iter + len;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "for (std::size_t idx = 0U; idx < count; ++idx) {\n" <<
+           output::indent(2) << "iter = TElement::skip(iter, end, blockLength, version);\n" <<
+           output::indent(2) << "if (iter == nullptr) {\n" <<
+           output::indent(3) << "return nullptr;\n" <<
+           output::indent(2) << "}\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "return iter;\n"
+           "}\n\n"
+           "/// \\brief Lazy view of the \"group\" list.\n"
+           "/// \\details The elements are created on iteration, the list is expected\n"
+           "///     to be validated by the containing message view.\n"
+           "/// \\tparam TElement View of the single element of the list.\n";
+    writeHeaderfileInfo(out, ns, common::viewStr());
+    out << "template <typename TElement>\n"
+           "class GroupView\n"
+           "{\n"
+           "public:\n" <<
+           output::indent(1) << "/// \\brief Forward iterator over the elements.\n" <<
+           output::indent(1) << "class Iterator\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(1) << "public:\n" <<
+           output::indent(2) << "using iterator_category = std::forward_iterator_tag;\n" <<
+           output::indent(2) << "using value_type = TElement;\n" <<
+           output::indent(2) << "using difference_type = std::ptrdiff_t;\n" <<
+           output::indent(2) << "using pointer = const TElement*;\n" <<
+           output::indent(2) << "using reference = TElement;\n\n" <<
+           output::indent(2) << "Iterator(const std::uint8_t* buf, std::size_t idx, std::size_t blockLength, unsigned version)\n" <<
+           output::indent(2) << "  : m_buf(buf),\n" <<
+           output::indent(2) << "    m_idx(idx),\n" <<
+           output::indent(2) << "    m_blockLength(blockLength),\n" <<
+           output::indent(2) << "    m_version(version)\n" <<
+           output::indent(2) << "{\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "TElement operator*() const\n" <<
+           output::indent(2) << "{\n" <<
+           output::indent(3) << "return TElement(m_buf, m_blockLength, m_version);\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "Iterator& operator++()\n" <<
+           output::indent(2) << "{\n" <<
+           output::indent(3) << "m_buf = TElement::skip(m_buf, nullptr, m_blockLength, m_version);\n" <<
+           output::indent(3) << "++m_idx;\n" <<
+           output::indent(3) << "return *this;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "Iterator operator++(int)\n" <<
+           output::indent(2) << "{\n" <<
+           output::indent(3) << "Iterator tmp(*this);\n" <<
+           output::indent(3) << "++(*this);\n" <<
+           output::indent(3) << "return tmp;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "bool operator==(const Iterator& other) const\n" <<
+           output::indent(2) << "{\n" <<
+           output::indent(3) << "return m_idx == other.m_idx;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "bool operator!=(const Iterator& other) const\n" <<
+           output::indent(2) << "{\n" <<
+           output::indent(3) << "return m_idx != other.m_idx;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(1) << "private:\n" <<
+           output::indent(2) << "const std::uint8_t* m_buf = nullptr;\n" <<
+           output::indent(2) << "std::size_t m_idx = 0U;\n" <<
+           output::indent(2) << "std::size_t m_blockLength = 0U;\n" <<
+           output::indent(2) << "unsigned m_version = 0U;\n" <<
+           output::indent(1) << "};\n\n" <<
+           output::indent(1) << "/// \\brief Default constructor, creates empty list.\n" <<
+           output::indent(1) << "GroupView() = default;\n\n" <<
+           output::indent(1) << "/// \\brief Constructor.\n" <<
+           output::indent(1) << "/// \\param[in] dim Position of the dimension type preceding the elements.\n" <<
+           output::indent(1) << "/// \\param[in] version Version of the containing message.\n" <<
+           output::indent(1) << "GroupView(const std::uint8_t* dim, unsigned version)\n" <<
+           output::indent(1) << "  : m_buf(dim + TElement::dimensionLength()),\n" <<
+           output::indent(1) << "    m_count(TElement::readNumInGroup(dim)),\n" <<
+           output::indent(1) << "    m_blockLength(TElement::readBlockLength(dim)),\n" <<
+           output::indent(1) << "    m_version(version)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Number of elements.\n" <<
+           output::indent(1) << "std::size_t size() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_count;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Check the list is empty.\n" <<
+           output::indent(1) << "bool empty() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_count == 0U;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Iterator to the first element.\n" <<
+           output::indent(1) << "Iterator begin() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return Iterator(m_buf, 0U, m_blockLength, m_version);\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Iterator past the last element.\n" <<
+           output::indent(1) << "Iterator end() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return Iterator(nullptr, m_count, m_blockLength, m_version);\n" <<
+           output::indent(1) << "}\n\n"
+           "private:\n" <<
+           output::indent(1) << "const std::uint8_t* m_buf = nullptr;\n" <<
+           output::indent(1) << "std::size_t m_count = 0U;\n" <<
+           output::indent(1) << "std::size_t m_blockLength = 0U;\n" <<
+           output::indent(1) << "unsigned m_version = 0U;\n"
+           "};\n\n";
+    writeNamespaceEnd(out, ns);
+    return out.commit();
+}
+
+bool writeEncoder(DB& db)
+{
+    auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::encoderFileName());
+    auto filePath = bf::path(db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    auto& ns = db.getProtocolNamespace();
+    out << "/// \\file\n"
+           "/// \\brief Contains helper classes and functions used by the generated message encoders.\n"
+           "\n\n"
+           "#pragma once\n\n"
+           "#include <cstdint>\n"
+           "#include <cstddef>\n"
+           "#include <cstring>\n"
+           "#include <type_traits>\n\n"
+           "#include \"comms/util/access.h\"\n\n";
+    writeNamespaceBegin(out, ns);
+    out << "namespace details\n"
+           "{\n\n"
+           "template <typename T, typename TEndian>\n"
+           "void encoderWrite(std::uint8_t* buf, T val, std::false_type)\n"
+           "{\n" <<
+           output::indent(1) << "comms::util::writeData(val, buf, TEndian());\n"
+           "}\n\n"
+           "template <typename T, typename TEndian>\n"
+           "void encoderWrite(std::uint8_t* buf, T val, std::true_type)\n"
+           "{\n" <<
+           output::indent(1) << "using IntType =\n" <<
+           output::indent(2) << "typename std::conditional<\n" <<
+           output::indent(3) << "sizeof(T) == sizeof(std::uint32_t),\n" <<
+           output::indent(3) << "std::uint32_t,\n" <<
+           output::indent(3) << "std::uint64_t\n" <<
+           output::indent(2) << ">::type;\n" <<
+           output::indent(1) << "IntType intVal;\n" <<
+           output::indent(1) << "std::memcpy(&intVal, &val, sizeof(intVal));\n" <<
+           output::indent(1) << "comms::util::writeData(intVal, buf, TEndian());\n"
+           "}\n\n"
+           "} // namespace details\n\n"
+           "/// \\brief Write single value into the raw buffer.\n"
+           "/// \\tparam T Type of the value.\n"
+           "/// \\tparam TEndian Endianness tag of the schema.\n"
+           "template <typename T, typename TEndian>\n"
+           "void encoderWrite(std::uint8_t* buf, T val)\n"
+           "{\n" <<
+           output::indent(1) << "details::encoderWrite<T, TEndian>(buf, val, std::is_floating_point<T>());\n"
+           "}\n\n"
+           "/// \\brief Copy characters into the fixed length array.\n"
+           "/// \\details The string is truncated to the array length, the rest\n"
+           "///     of the array is filled with zeroes.\n"
+           "inline void encoderWriteChars(std::uint8_t* buf, std::size_t count, const char* str, std::size_t len)\n"
+           "{\n" <<
+           output::indent(1) << "if (count < len) {\n" <<
+           output::indent(2) << "len = count;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "if (0U < len) {\n" <<
+           output::indent(2) << "std::memcpy(buf, str, len);\n" <<
+           output::indent(1) << "}\n" <<
+           output::indent(1) << "std::memset(buf + len, 0, count - len);\n"
+           "}\n\n"
+           "/// \\brief Position of the message encoder in the output buffer.\n"
+           "/// \\details Shared by the message encoder and all its group element encoders,\n"
+           "///     the blocks, the group dimensions and the data fields are appended\n"
+           "///     to the buffer in order of their encoding.\n";
+    writeHeaderfileInfo(out, ns, common::encoderStr());
+    out << "class EncoderCursor\n"
+           "{\n"
+           "public:\n" <<
+           output::indent(1) << "/// \\brief Default constructor, creates invalid cursor.\n" <<
+           output::indent(1) << "EncoderCursor() = default;\n\n" <<
+           output::indent(1) << "/// \\brief Constructor.\n" <<
+           output::indent(1) << "EncoderCursor(std::uint8_t* buf, std::size_t len) : m_buf(buf), m_len(len) {}\n\n" <<
+           output::indent(1) << "/// \\brief Reserve zero filled area at the end of the encoded data.\n" <<
+           output::indent(1) << "/// \\return Start of the area or \\b nullptr if it doesn't fit into the buffer,\n" <<
+           output::indent(1) << "///     in which case the cursor becomes invalid.\n" <<
+           output::indent(1) << "std::uint8_t* append(std::size_t len)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "if ((m_buf == nullptr) || ((m_len - m_pos) < len)) {\n" <<
+           output::indent(3) << "invalidate();\n" <<
+           output::indent(3) << "return nullptr;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "auto* result = m_buf + m_pos;\n" <<
+           output::indent(2) << "if (0U < len) {\n" <<
+           output::indent(3) << "std::memset(result, 0, len);\n" <<
+           output::indent(2) << "}\n" <<
+           output::indent(2) << "m_pos += len;\n" <<
+           output::indent(2) << "return result;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Mark the encoding as failed.\n" <<
+           output::indent(1) << "void invalidate()\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "m_buf = nullptr;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Check all the appended data fitted into the buffer.\n" <<
+           output::indent(1) << "bool valid() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_buf != nullptr;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Number of bytes appended so far.\n" <<
+           output::indent(1) << "std::size_t length() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_pos;\n" <<
+           output::indent(1) << "}\n\n"
+           "private:\n" <<
+           output::indent(1) << "std::uint8_t* m_buf = nullptr;\n" <<
+           output::indent(1) << "std::size_t m_len = 0U;\n" <<
+           output::indent(1) << "std::size_t m_pos = 0U;\n"
+           "};\n\n"
+           "/// \\brief Append the \"data\" field.\n"
+           "/// \\tparam TLen Type of the length prefix.\n"
+           "/// \\tparam TEndian Endianness tag of the schema.\n"
+           "/// \\param[in] maxLen Maximal length allowed by the length prefix.\n"
+           "/// \\return \\b false if the data is too long for its length prefix\n"
+           "///     or doesn't fit into the buffer.\n"
+           "template <typename TLen, typename TEndian>\n"
+           "bool encoderAppendData(EncoderCursor& cursor, const void* data, std::size_t len, std::size_t maxLen)\n"
+           "{\n" <<
+           output::indent(1) << "if (maxLen < len) {\n" <<
+           output::indent(2) << "cursor.invalidate();\n" <<
+           output::indent(2) << "return false;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "auto* buf = cursor.append(sizeof(TLen) + len);\n" <<
+           output::indent(1) << "if (buf == nullptr) {\n" <<
+           output::indent(2) << "return false;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "encoderWrite<TLen, TEndian>(buf, static_cast<TLen>(len));\n" <<
+           output::indent(1) << "if (0U < len) {\n" <<
+           output::indent(2) << "std::memcpy(buf + sizeof(TLen), data, len);\n" <<
+           output::indent(1) << "}\n" <<
+           output::indent(1) << "return true;\n"
+           "}\n\n"
+           "/// \\brief Builder of the \"group\" list.\n"
+           "/// \\details Appends the dimension type on construction and keeps its\n"
+           "///     \\b numInGroup member up to date with every appended element.\n"
+           "/// \\tparam TElement Encoder of the single element of the list.\n";
+    writeHeaderfileInfo(out, ns, common::encoderStr());
+    out << "template <typename TElement>\n"
+           "class GroupBuilder\n"
+           "{\n"
+           "public:\n" <<
+           output::indent(1) << "/// \\brief Constructor.\n" <<
+           output::indent(1) << "explicit GroupBuilder(EncoderCursor& cursor)\n" <<
+           output::indent(1) << "  : m_cursor(&cursor),\n" <<
+           output::indent(1) << "    m_dim(cursor.append(TElement::dimensionLength()))\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "if (m_dim != nullptr) {\n" <<
+           output::indent(3) << "TElement::writeDimension(m_dim, 0U);\n" <<
+           output::indent(2) << "}\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Append new element.\n" <<
+           output::indent(1) << "/// \\details The returned encoder is invalid if the element doesn't fit\n" <<
+           output::indent(1) << "///     into the buffer or the \\b numInGroup limit is reached.\n" <<
+           output::indent(1) << "TElement next()\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "if ((m_dim == nullptr) || (TElement::maxNumInGroup() <= m_count)) {\n" <<
+           output::indent(3) << "m_cursor->invalidate();\n" <<
+           output::indent(3) << "return TElement(*m_cursor, nullptr);\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "auto* buf = m_cursor->append(TElement::schemaBlockLength());\n" <<
+           output::indent(2) << "if (buf != nullptr) {\n" <<
+           output::indent(3) << "++m_count;\n" <<
+           output::indent(3) << "TElement::writeDimension(m_dim, m_count);\n" <<
+           output::indent(2) << "}\n" <<
+           output::indent(2) << "return TElement(*m_cursor, buf);\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Number of appended elements.\n" <<
+           output::indent(1) << "std::size_t size() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return m_count;\n" <<
+           output::indent(1) << "}\n\n"
+           "private:\n" <<
+           output::indent(1) << "EncoderCursor* m_cursor = nullptr;\n" <<
+           output::indent(1) << "std::uint8_t* m_dim = nullptr;\n" <<
+           output::indent(1) << "std::size_t m_count = 0U;\n"
+           "};\n\n";
+    writeNamespaceEnd(out, ns);
+    return out.commit();
+}
+
+bool writeLazyRead(DB& db)
+{
+    auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::builtinNamespaceNameStr() + '/' + common::lazyReadFileName());
+    auto filePath = bf::path(db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    auto& ns = db.getProtocolNamespace();
+    out << "/// \\file\n"
+           "/// \\brief Contains definition of the lazy read modes of the messages.\n"
+           "\n\n"
+           "#pragma once\n\n"
+           "#include <cstdint>\n"
+           "#include <type_traits>\n\n";
+    writeNamespaceBegin(out, ns);
+    out << "/// \\brief The groups and data fields are decoded by the message read.\n";
+    writeHeaderfileInfo(out, ns, common::lazyReadStr());
+    out << "struct " << common::lazyReadStr() << "Disabled {};\n\n"
+           "/// \\brief The lengths of the groups and data fields are validated by the\n"
+           "///     message read, while the fields are decoded on their first access.\n";
+    writeHeaderfileInfo(out, ns, common::lazyReadStr());
+    out << "struct " << common::lazyReadStr() << "Validated {};\n\n"
+           "/// \\brief The message read consumes all the remaining input without\n"
+           "///     validation, the groups and data fields are decoded on their\n"
+           "///     first access.\n"
+           "/// \\details Suitable only when the framing reports the exact length of\n"
+           "///     the message, like \\b SimpleOpenFramingHeader does.\n";
+    writeHeaderfileInfo(out, ns, common::lazyReadStr());
+    out << "struct " << common::lazyReadStr() << "Unchecked {};\n\n"
+           "/// \\brief Lazy read mode used with the provided iterator.\n"
+           "/// \\details The recorded data is accessed through the raw pointer, the\n"
+           "///     iterators not convertible to it are always read eagerly.\n"
+           "template <typename TMode, typename TIter>\n"
+           "using " << common::lazyReadStr() << "ModeFor =\n" <<
+           output::indent(1) << "typename std::conditional<\n" <<
+           output::indent(2) << "std::is_convertible<TIter, const std::uint8_t*>::value,\n" <<
+           output::indent(2) << "TMode,\n" <<
+           output::indent(2) << common::lazyReadStr() << "Disabled\n" <<
+           output::indent(1) << ">::type;\n\n";
+    writeNamespaceEnd(out, ns);
+    return out.commit();
 }
 
 } // namespace
@@ -579,6 +1228,22 @@ bool BuiltIn::write()
     if (!writeVersionSetter(m_db)) {
         return false;
     }
+
+    if (!writeProjection(m_db)) {
+        return false;
+    }
+
+    if (m_db.isViewEnabled() && (!writeView(m_db))) {
+        return false;
+    }
+
+    if (m_db.isEncoderEnabled() && (!writeEncoder(m_db))) {
+        return false;
+    }
+
+    if (m_db.isLazyReadEnabled() && (!writeLazyRead(m_db))) {
+        return false;
+    }
     return true;
 }
 
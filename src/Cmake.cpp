@@ -18,7 +18,6 @@
 #include "Cmake.h"
 
 #include <iostream>
-#include <fstream>
 //#include <algorithm>
 
 #include <boost/filesystem.hpp>
@@ -28,6 +27,7 @@
 #include "output.h"
 #include "DB.h"
 #include "log.h"
+#include "OutputFile.h"
 
 namespace bf = boost::filesystem;
 namespace ba = boost::algorithm;
@@ -35,6 +35,26 @@ namespace ba = boost::algorithm;
 namespace sbe2comms
 {
 
+namespace
+{
+
+// Number of plugin messages compiled together in the unity build.
+const std::size_t MessagesPerUnityBatch = 16U;
+
+const std::string PchFileName("pch.h");
+
+std::size_t unityBatchesCount(const DB& db)
+{
+    return (db.getMessagesById().size() + MessagesPerUnityBatch - 1U) / MessagesPerUnityBatch;
+}
+
+std::string unityBatchRelPath(std::size_t idx)
+{
+    return "unity/messages" + std::to_string(idx) + ".cpp";
+}
+
+} // namespace
+
 Cmake::Cmake(DB& db)
   : m_db(db),
     m_name(db.getPackageName())
@@ -47,23 +67,23 @@ Cmake::Cmake(DB& db)
 
 bool Cmake::write()
 {
-    return writeMain() && writePlugin();
+    if (!writeMain()) {
+        return false;
+    }
+
+    if (!m_db.isComponentEnabled(DB::Component::Plugin)) {
+        return true;
+    }
+
+    return writePlugin() && writePluginUnity() && writePluginPch();
 }
 
 bool Cmake::writeMain()
 {
-    boost::system::error_code ec;
-    bf::create_directories(m_db.getRootPath(), ec);
-    if (ec) {
-        log::error() << "Failed to create \"" << m_db.getRootPath() <<
-                "\" with error \"" << ec.message() << "\"!" << std::endl;
-        return false;
-    }
-
     auto relPath = common::cmakeListsFileName();
     auto filePath = bf::path( m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -75,7 +95,14 @@ bool Cmake::writeMain()
            "option (OPT_LIB_ONLY \"Install only protocol library, no other libraries/plugings are built/installed.\" OFF)\n"
            "option (OPT_THIS_AND_COMMS_LIBS_ONLY \"Install this protocol and COMMS libraries only, no other applications/plugings are built/installed.\" OFF)\n"
            "option (OPT_FULL_SOLUTION \"Build and install full solution, including CommsChampion sources.\" ON)\n"
-           "option (OPT_NO_WARN_AS_ERR \"Do NOT treat warning as error\" OFF)\n\n"
+           "option (OPT_NO_WARN_AS_ERR \"Do NOT treat warning as error\" OFF)\n";
+
+    if (m_db.isComponentEnabled(DB::Component::Plugin)) {
+        out << "option (OPT_UNITY_BUILD \"Compile plugin messages in batches (unity build).\" OFF)\n"
+               "option (OPT_USE_PCH \"Use precompiled header when compiling plugin (requires CMake v3.16).\" OFF)\n";
+    }
+
+    out << "\n"
            "# Other parameters:\n"
            "# OPT_INSTALL_DIR - Custom install directory.\n"
            "# OPT_QT_DIR - Path to custom Qt5 install directory.\n"
@@ -102,29 +129,13 @@ bool Cmake::writeMain()
            output::indent(1) << "DESTINATION ${INC_INSTALL_DIR}\n"
            ")\n\n"
            "FILE(GLOB_RECURSE protocol.headers \"include/*.h\")\n"
-           "add_custom_target(" << m_name << ".headers SOURCES ${protocol.headers})\n\n"
-           "find_package (Doxygen)\n"
-           "if (DOXYGEN_FOUND)\n" <<
-           output::indent(1) << "set (doc_output_dir \"${DOC_INSTALL_DIR}/" << m_name << "\")\n" <<
-           output::indent(1) << "make_directory (${doc_output_dir})\n\n" <<
-           output::indent(1) << "if (\"${OPT_DOXYGEN_CONFIG_FILE}\" STREQUAL \"\")\n" <<
-           output::indent(2) << "set (match_str \"OUTPUT_DIRECTORY[^\\n]*\")\n" <<
-           output::indent(2) << "set (replacement_str \"OUTPUT_DIRECTORY = ${doc_output_dir}\")\n" <<
-           output::indent(2) << "set (config_file \"${CMAKE_CURRENT_SOURCE_DIR}/doc/doxygen.conf\")\n" <<
-           output::indent(2) << "set (OPT_DOXYGEN_CONFIG_FILE \"${CMAKE_CURRENT_BINARY_DIR}/doxygen.conf\")\n\n" <<
-           output::indent(2) << "file (READ ${config_file} config_text)\n" <<
-           output::indent(2) << "string (REGEX REPLACE \"${match_str}\" \"${replacement_str}\" modified_config_text \"${config_text}\")\n" <<
-           output::indent(2) << "file (WRITE \"${OPT_DOXYGEN_CONFIG_FILE}\" \"${modified_config_text}\")\n" <<
-           output::indent(1) << "endif ()\n\n" <<
-           output::indent(1) << "if (NOT EXISTS ${OPT_DOXYGEN_CONFIG_FILE})\n" <<
-           output::indent(2) << "message(FATAL_ERROR \"Doxygen configuration file ${OPT_DOXYGEN_CONFIG_FILE} does not exist\")\n" <<
-           output::indent(1) << "endif ()\n\n" <<
-           output::indent(1) << "set (doc_tgt \"doc_" << m_name << "\")\n" <<
-           output::indent(1) << "add_custom_target (\"${doc_tgt}\"\n" <<
-           output::indent(2) << "COMMAND ${DOXYGEN_EXECUTABLE} ${OPT_DOXYGEN_CONFIG_FILE}\n" <<
-           output::indent(2) << "WORKING_DIRECTORY ${CMAKE_SOURCE_DIR})\n"
-           "endif ()\n\n"
-           "if (OPT_LIB_ONLY)\n" <<
+           "add_custom_target(" << m_name << ".headers SOURCES ${protocol.headers})\n\n";
+
+    if (m_db.isComponentEnabled(DB::Component::Doc)) {
+        writeDoc(out);
+    }
+
+    out << "if (OPT_LIB_ONLY)\n" <<
            output::indent(1) << "return ()\n"
            "endif ()\n\n"
            "######################################################################\n\n"
@@ -241,44 +252,110 @@ bool Cmake::writeMain()
            output::indent(1) << "BEFORE\n" <<
            output::indent(1) << "${CMAKE_SOURCE_DIR}\n" <<
            output::indent(1) << "${CMAKE_SOURCE_DIR}/include\n"
-           ")\n\n"
-           "add_subdirectory(cc_plugin)\n\n";
+           ")\n\n";
 
-    return true;
+    if (m_db.hasExplicitInstantiation()) {
+        writeMessagesLib(out);
+    }
+
+    if (m_db.isComponentEnabled(DB::Component::Plugin)) {
+        out << "add_subdirectory(cc_plugin)\n\n";
+    }
+
+    return out.commit();
 }
 
-bool Cmake::writePlugin()
+void Cmake::writeDoc(std::ostream& out)
 {
-    boost::system::error_code ec;
-    bf::create_directories(m_db.getRootPath(), ec);
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
+    out << "find_package (Doxygen)\n"
+           "if (DOXYGEN_FOUND)\n" <<
+           output::indent(1) << "set (doc_output_dir \"${DOC_INSTALL_DIR}/" << m_name << "\")\n" <<
+           output::indent(1) << "make_directory (${doc_output_dir})\n\n" <<
+           output::indent(1) << "if (\"${OPT_DOXYGEN_CONFIG_FILE}\" STREQUAL \"\")\n" <<
+           output::indent(2) << "set (match_str \"OUTPUT_DIRECTORY[^\\n]*\")\n" <<
+           output::indent(2) << "set (replacement_str \"OUTPUT_DIRECTORY = ${doc_output_dir}\")\n" <<
+           output::indent(2) << "set (config_file \"${CMAKE_CURRENT_SOURCE_DIR}/doc/doxygen.conf\")\n" <<
+           output::indent(2) << "set (OPT_DOXYGEN_CONFIG_FILE \"${CMAKE_CURRENT_BINARY_DIR}/doxygen.conf\")\n\n" <<
+           output::indent(2) << "file (READ ${config_file} config_text)\n" <<
+           output::indent(2) << "string (REGEX REPLACE \"${match_str}\" \"${replacement_str}\" modified_config_text \"${config_text}\")\n" <<
+           output::indent(2) << "file (WRITE \"${OPT_DOXYGEN_CONFIG_FILE}\" \"${modified_config_text}\")\n" <<
+           output::indent(1) << "endif ()\n\n" <<
+           output::indent(1) << "if (NOT EXISTS ${OPT_DOXYGEN_CONFIG_FILE})\n" <<
+           output::indent(2) << "message(FATAL_ERROR \"Doxygen configuration file ${OPT_DOXYGEN_CONFIG_FILE} does not exist\")\n" <<
+           output::indent(1) << "endif ()\n\n" <<
+           output::indent(1) << "set (doc_tgt \"doc_" << m_name << "\")\n" <<
+           output::indent(1) << "add_custom_target (\"${doc_tgt}\"\n" <<
+           output::indent(2) << "COMMAND ${DOXYGEN_EXECUTABLE} ${OPT_DOXYGEN_CONFIG_FILE}\n" <<
+           output::indent(2) << "WORKING_DIRECTORY ${CMAKE_SOURCE_DIR})\n"
+           "endif ()\n\n";
+}
+
+void Cmake::writeMessagesLib(std::ostream& out)
+{
+    out << "set (MESSAGES_LIB \"" << m_name << "_messages\")\n"
+           "set (messages_src\n" <<
+           output::indent(1) << common::srcDirName() << '/' << common::msgInterfaceStr() << ".cpp\n";
+    for (auto& m : m_db.getMessagesById()) {
+        out << output::indent(1) << common::srcDirName() << '/' << common::messageNamespaceNameStr() << '/' << m.second->first << ".cpp\n";
     }
+    out << ")\n\n"
+           "add_library (${MESSAGES_LIB} STATIC ${messages_src})\n"
+           "if (CC_EXTERNAL)\n" <<
+           output::indent(1) << "add_dependencies(${MESSAGES_LIB} ${CC_EXTERNAL_TGT})\n"
+           "endif ()\n\n"
+           "install (\n" <<
+           output::indent(1) << "TARGETS ${MESSAGES_LIB}\n" <<
+           output::indent(1) << "DESTINATION ${LIB_INSTALL_DIR})\n\n";
+}
 
+bool Cmake::writePlugin()
+{
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::cmakeListsFileName();
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
     }
 
     out << "set (ALL_MESSAGES_LIB \"all_messages\")\n\n"
+           "######################################################################\n\n"
+           "function (cc_plugin_pch name)\n" <<
+           output::indent(1) << "if (NOT OPT_USE_PCH)\n" <<
+           output::indent(2) << "return ()\n" <<
+           output::indent(1) << "endif ()\n\n" <<
+           output::indent(1) << "if (CMAKE_VERSION VERSION_LESS \"3.16\")\n" <<
+           output::indent(2) << "message (WARNING \"Precompiled headers require CMake v3.16 or above, not used for ${name}\")\n" <<
+           output::indent(2) << "return ()\n" <<
+           output::indent(1) << "endif ()\n\n" <<
+           output::indent(1) << "target_precompile_headers (${name} PRIVATE \"${CMAKE_CURRENT_SOURCE_DIR}/" << PchFileName << "\")\n"
+           "endfunction()\n\n"
            "######################################################################\n\n"
            "function (cc_plugin_all_messages)\n" <<
            output::indent(1) << "set (name \"${ALL_MESSAGES_LIB}\")\n\n" <<
-           output::indent(1) << "set (src\n" <<
-           output::indent(2) << common::fieldDefFileName() << '\n';
+           output::indent(1) << "if (OPT_UNITY_BUILD)\n" <<
+           output::indent(2) << "set (src\n" <<
+           output::indent(3) << common::fieldDefFileName() << '\n';
+    auto batchesCount = unityBatchesCount(m_db);
+    for (auto idx = 0U; idx < batchesCount; ++idx) {
+        out << output::indent(3) << unityBatchRelPath(idx) << '\n';
+    }
+    out << output::indent(2) << ")\n" <<
+           output::indent(1) << "else ()\n" <<
+           output::indent(2) << "set (src\n" <<
+           output::indent(3) << common::fieldDefFileName() << '\n';
     auto& msgs = m_db.getMessagesById();
     for (auto& m : msgs) {
         assert(m.second != m_db.getMessages().end());
-        out << output::indent(2) << common::messageDirName() << '/' << m.second->first << ".cpp\n";
+        out << output::indent(3) << common::messageDirName() << '/' << m.second->first << ".cpp\n";
     }
-    out << output::indent(1) << ")\n\n" <<
+    out << output::indent(2) << ")\n" <<
+           output::indent(1) << "endif ()\n\n" <<
            output::indent(1) << "add_library (${name} STATIC ${src})\n" <<
            output::indent(1) << "target_link_libraries (${name} ${CC_PLUGIN_LIBRARIES})\n" <<
-           output::indent(1) << "qt5_use_modules(${name} Core)\n"
+           output::indent(1) << "qt5_use_modules(${name} Core)\n" <<
+           output::indent(1) << "cc_plugin_pch (${name})\n"
            "endfunction()\n\n"
            "######################################################################\n\n"
            "function (cc_plugin variant)\n" <<
@@ -303,6 +380,7 @@ bool Cmake::writePlugin()
            output::indent(1) << "add_library (${name} SHARED ${src} ${moc})\n" <<
            output::indent(1) << "target_link_libraries (${name} ${ALL_MESSAGES_LIB} ${CC_PLUGIN_LIBRARIES})\n" <<
            output::indent(1) << "qt5_use_modules (${name} Core)\n" <<
+           output::indent(1) << "cc_plugin_pch (${name})\n" <<
            output::indent(1) << "install (\n" <<
            output::indent(2) << "TARGETS ${name}\n" <<
            output::indent(2) << "DESTINATION ${PLUGIN_INSTALL_DIR})\n\n" <<
@@ -324,8 +402,52 @@ bool Cmake::writePlugin()
            "FILE(GLOB_RECURSE plugin.headers \"*.h\")\n"
            "add_custom_target(cc_plugin.headers SOURCES ${plugin.headers})\n\n";
 
+    return out.commit();
+}
+
+bool Cmake::writePluginUnity()
+{
+    auto& msgs = m_db.getMessagesById();
+    auto iter = msgs.begin();
+    auto batchesCount = unityBatchesCount(m_db);
+    for (auto idx = 0U; idx < batchesCount; ++idx) {
+        auto relPath = common::pluginNamespaceNameStr() + '/' + unityBatchRelPath(idx);
+        auto filePath = bf::path(m_db.getRootPath()) / relPath;
+        log::info() << "Generating " << relPath << std::endl;
+        OutputFile out(m_db, filePath.string());
+        if (!out) {
+            log::error() << "Failed to create " << filePath.string() << std::endl;
+            return false;
+        }
+
+        for (auto count = 0U; (count < MessagesPerUnityBatch) && (iter != msgs.end()); ++count, ++iter) {
+            out << "#include \"" << common::pluginNamespaceNameStr() << '/' << common::messageDirName() << '/' << iter->second->first << ".cpp\"\n";
+        }
+
+        if (!out.commit()) {
+            return false;
+        }
+    }
     return true;
 }
 
+bool Cmake::writePluginPch()
+{
+    auto relPath = common::pluginNamespaceNameStr() + '/' + PchFileName;
+    auto filePath = bf::path(m_db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(m_db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    out << "#pragma once\n\n"
+           "#include <cassert>\n"
+           "#include <QtCore/QVariantList>\n"
+           "#include \"comms_champion/comms_champion.h\"\n"
+           "#include " << common::localHeader(m_db.getProtocolNamespace(), common::allMessagesFileName()) << "\n";
+    return out.commit();
+}
 
 } // namespace sbe2comms
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <string>
+#include <iosfwd>
 
 namespace sbe2comms
 {
@@ -32,6 +33,10 @@ public:
 private:
     bool writeMain();
     bool writePlugin();
+    void writeDoc(std::ostream& out);
+    void writeMessagesLib(std::ostream& out);
+    bool writePluginUnity();
+    bool writePluginPch();
 
     DB& m_db;
     std::string m_name;
@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <numeric>
+#include <algorithm>
 
 #include <boost/algorithm/string.hpp>
 
@@ -48,6 +49,27 @@ enum DataEncIdx
 
 const std::string OptPrefix("TOpt_");
 
+// Schemas tend to specify huge limits, use fixed size storage only for
+// reasonably small ones.
+const std::intmax_t MaxFixedGroupStorage = 256;
+const std::intmax_t MaxFixedDataStorage = 1024;
+
+unsigned fixedStorageSize(const Type& t, std::intmax_t limit)
+{
+    auto& maxValue = t.getMaxValue();
+    if ((t.getKind() != Type::Kind::Basic) || maxValue.empty()) {
+        return 0U;
+    }
+
+    auto& primType = asBasicType(t).getPrimitiveType();
+    auto maxVal = common::intMaxValue(primType, maxValue);
+    if ((!maxVal.second) || (maxVal.first <= 0) || (limit < maxVal.first)) {
+        return 0U;
+    }
+
+    return static_cast<unsigned>(maxVal.first);
+}
+
 } // namespace
 
 bool CompositeType::isBundleOptional() const
@@ -111,6 +133,32 @@ bool CompositeType::verifyValidDimensionType() const
            findNameFunc(common::numInGroupStr());
 }
 
+unsigned CompositeType::getMaxNumInGroup() const
+{
+    auto iter =
+        std::find_if(
+            m_members.begin(), m_members.end(),
+            [](const TypePtr& t)
+            {
+                return t->getName() == common::numInGroupStr();
+            });
+
+    if (iter == m_members.end()) {
+        return 0U;
+    }
+
+    return fixedStorageSize(**iter, MaxFixedGroupStorage);
+}
+
+unsigned CompositeType::getMaxDataLength() const
+{
+    if (m_members.size() != DataEncIdx_numOfValues) {
+        return 0U;
+    }
+
+    return fixedStorageSize(*m_members[DataEncIdx_length], MaxFixedDataStorage);
+}
+
 bool CompositeType::isValidData() const
 {
     auto verifyLengthFunc =
@@ -366,6 +414,9 @@ Type::AliasTemplateArgsList CompositeType::getAliasTemplateArgumentsImpl() const
 
     if (dataUseRecorded() && isValidData()) {
         list.push_back("TOpt");
+        if (getMaxDataLength() != 0U) {
+            list.push_back("TStorage");
+        }
     }
     return list;
 }
@@ -429,7 +480,7 @@ bool CompositeType::prepareMembers()
             assert(padMem->getSerializationLength() == padLen);
             expOffset += padLen;
             m_members.push_back(std::move(padMem));
-            xmlAddPrevSibling(c, padNode.release());
+            m_paddingNodes.push_back(std::move(padNode));
         } while (false);
 
         expOffset += mem->getSerializationLength();
@@ -621,21 +672,35 @@ bool CompositeType::writeData(
     writeHeader(out, indent, commsOptionalWrapped, false);
     writeExtraOptsDoc(out, indent, allExtraOpts);
     common::writeExtraOptionsDoc(out, indent);
-    writeExtraOptsTemplParams(out, indent, allExtraOpts, true);
+    bool bounded = (getMaxDataLength() != 0U);
+    if (bounded) {
+        out << output::indent(indent) << "/// \\tparam TStorage Storage option of the data, the length is limited to " << getMaxDataLength() << ".\n";
+    }
+    writeExtraOptsTemplParams(out, indent, allExtraOpts, true, bounded);
     auto& lenMem = *m_members[DataEncIdx_length];
     auto& dataMem = *m_members[DataEncIdx_data];
     auto& suffix = getNameSuffix(commsOptionalWrapped, false);
     auto name = common::refName(getName(), suffix);
 
     auto writeClassDefFunc =
-        [this, &out, &lengthExtraOpt, &dataExtraOpt, &dataMem, &lenMem](unsigned ind)
+        [this, &out, &lengthExtraOpt, &dataExtraOpt, &dataMem, &lenMem, bounded](unsigned ind)
         {
             out << output::indent(ind) << getName() << common::memembersSuffixStr() << "::" << dataMem.getReferenceName() << "<\n" <<
                    output::indent(ind + 1) << "comms::option::SequenceSerLengthFieldPrefix<\n" <<
-                   output::indent(ind + 2) << getName() << common::memembersSuffixStr() << "::" << lenMem.getReferenceName() << '<' << OptPrefix << lengthExtraOpt << ">\n" <<
+                   output::indent(ind + 2) << getName() << common::memembersSuffixStr() << "::" << lenMem.getReferenceName() << '<' << OptPrefix << lengthExtraOpt;
+            if (bounded) {
+                // Reject the oversized data before reading it into fixed size storage
+                out << ", comms::option::FailOnInvalid<> ";
+            }
+            out << ">\n" <<
                    output::indent(ind + 1) << ">,\n" <<
                    output::indent(ind + 1) << OptPrefix << dataExtraOpt << ",\n" <<
-                   output::indent(ind + 1) << "TOpt\n" <<
+                   output::indent(ind + 1) << "TOpt";
+            if (bounded) {
+                out << ",\n" <<
+                       output::indent(ind + 1) << "TStorage";
+            }
+            out << '\n' <<
                    output::indent(ind) << ">";
         };
 
@@ -712,13 +777,14 @@ void CompositeType::writeExtraOptsTemplParams(
         std::ostream& out,
         unsigned indent,
         const AllExtraOptInfos& infos,
-        bool hasExtraOptions)
+        bool hasExtraOptions,
+        bool hasStorageOption)
 {
     out << output::indent(indent) << "template<\n";
     for (auto& l : infos) {
         for (auto& o : l) {
             out << output::indent(indent + 1) << "typename " << OptPrefix << o.first << common::eqEmptyOptionStr();
-            bool comma = (hasExtraOptions || (&l != &infos.back()) || (&o != &l.back()));
+            bool comma = (hasExtraOptions || hasStorageOption || (&l != &infos.back()) || (&o != &l.back()));
             if (comma) {
                 out << ',';
             }
@@ -726,7 +792,14 @@ void CompositeType::writeExtraOptsTemplParams(
         }
     }
     if (hasExtraOptions) {
-        out << output::indent(indent + 1) << "typename TOpt" << common::eqEmptyOptionStr() << '\n';
+        out << output::indent(indent + 1) << "typename TOpt" << common::eqEmptyOptionStr();
+        if (hasStorageOption) {
+            out << ',';
+        }
+        out << '\n';
+    }
+    if (hasStorageOption) {
+        out << output::indent(indent + 1) << "typename TStorage" << common::eqEmptyOptionStr() << '\n';
     }
     out << output::indent(indent) << ">\n";
 }
@@ -33,6 +33,8 @@ public:
 
     bool isBundleOptional() const;
     bool verifyValidDimensionType() const;
+    unsigned getMaxNumInGroup() const;
+    unsigned getMaxDataLength() const;
     bool isValidData() const;
     bool isBundle() const;
     void recordDataUse()
@@ -80,13 +82,15 @@ private:
         std::ostream& out,
         unsigned indent,
         const AllExtraOptInfos& infos,
-        bool hasExtraOptions = false);
+        bool hasExtraOptions = false,
+        bool hasStorageOption = false);
     bool isMessageHeader() const;
     bool checkMessageHeader();
     bool checkOpenFramingHeader();
     bool updateRangeOfSchemaId(Type& schemaId);
     bool updateRangeOfVersion(Type& version);
 
+    std::vector<XmlNodePtr> m_paddingNodes;
     Members m_members;
     bool m_dataUse = false;
 };
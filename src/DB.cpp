@@ -21,8 +21,10 @@
 #include <cassert>
 #include <functional>
 #include <algorithm>
+#include <sstream>
+#include <iterator>
+#include <type_traits>
 
-#include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include "BasicType.h"
@@ -32,26 +34,70 @@
 #include "prop.h"
 #include "common.h"
 #include "log.h"
+#include "stats.h"
+
+#ifdef SBE2COMMS_HAS_GENERATOR_HASH
+#include "GeneratorHash.h"
+#endif
 
-namespace bf = boost::filesystem;
 namespace ba = boost::algorithm;
 
 namespace sbe2comms
 {
 
-bool DB::parseSchema(const ProgramOptions& options)
+namespace
 {
-    auto filename = options.getFile();
-    if (filename.empty()) {
-        sbe2comms::log::error() << "Message schema hasn't been provided." << std::endl;
-        return false;
-    }
 
-    m_doc.reset(xmlParseFile(filename.c_str()));
-    if (!m_doc) {
-        log::error() << "Invalid schema file: \"" << filename << "\"!" << std::endl;
-        return false;
-    }
+// Any change in the generator itself must invalidate all the fingerprints.
+// The hash of the generator sources is provided by the build system,
+// otherwise the version must be bumped whenever the output changes.
+#ifdef SBE2COMMS_HAS_GENERATOR_HASH
+const std::string GeneratorBuildStamp(SBE2COMMS_GENERATOR_HASH);
+#else
+const std::string GeneratorBuildStamp("sbe2comms-output-1");
+#endif
+
+const std::string TypeRefProps[] = {
+    "type",
+    "encodingType",
+    "valueRef"
+};
+
+const std::string ComponentNames[] = {
+    "protocol",
+    "plugin",
+    "doc",
+    "cmake"
+};
+
+static_assert(
+    std::extent<decltype(ComponentNames)>::value == static_cast<std::size_t>(DB::Component::NumOfValues),
+    "Invalid names map");
+
+// Components, which must be generated together with the selected one.
+const std::vector<DB::Component> ComponentDeps[] = {
+    /* Protocol */ {},
+    /* Plugin */ {DB::Component::Protocol},
+    /* Doc */ {DB::Component::Protocol},
+    /* Cmake */ {DB::Component::Protocol}
+};
+
+static_assert(
+    std::extent<decltype(ComponentDeps)>::value == static_cast<std::size_t>(DB::Component::NumOfValues),
+    "Invalid dependencies map");
+
+} // namespace
+
+DB::DB(OutputSink& sink)
+  : m_generatedFiles(sink)
+{
+    m_components.fill(false);
+}
+
+bool DB::parseSchema(const ProgramOptions& options, XmlDocPtr doc)
+{
+    assert(doc);
+    m_doc = std::move(doc);
 
     auto* root = xmlDocGetRootElement(m_doc.get());
     if (root == nullptr) {
@@ -107,18 +153,41 @@ bool DB::parseSchema(const ProgramOptions& options)
         cur = cur->next;
     }
 
-    log::info() << "Generating files in " << m_rootDir << std::endl;
+    for (auto& f : m_messagesFilter) {
+        bool matched =
+            std::any_of(
+                m_messages.begin(), m_messages.end(),
+                [&f](const MessagesMap::value_type& m)
+                {
+                    return common::wildcardMatch(f, m.first);
+                });
 
-    for (auto& t : m_types) {
-        if (!t.second->parse()) {
-            return false;
+        if (!matched) {
+            log::warning() << "No message matches \"" << f << "\"." << std::endl;
         }
     }
 
-    for (auto& m : m_messages) {
-        assert(m.second);
-        if (!m.second->parse()) {
-            return false;
+    // Types used only by the filtered out messages are not needed
+    if (options.pruneTypesRequested() || (!m_messagesFilter.empty())) {
+        pruneUnusedTypes();
+    }
+
+    {
+        stats::Scope scope(stats::Kind::Phase, "types");
+        for (auto& t : m_types) {
+            if (!t.second->parse()) {
+                return false;
+            }
+        }
+    }
+
+    {
+        stats::Scope scope(stats::Kind::Phase, "messages");
+        for (auto& m : m_messages) {
+            assert(m.second);
+            if (!m.second->parse()) {
+                return false;
+            }
         }
     }
 
@@ -129,10 +198,15 @@ bool DB::parseSchema(const ProgramOptions& options)
 
 const std::string& DB::getRootPath() const
 {
-    assert(!m_rootDir.empty());
     return m_rootDir;
 }
 
+void DB::setRootPath(const std::string& path)
+{
+    m_rootDir = path;
+    m_generatedFiles.setRootPath(m_rootDir);
+}
+
 const std::string& DB::getProtocolNamespace() const
 {
     return m_namespace;
@@ -191,6 +265,38 @@ const std::string& DB::getEndian() const
     return m_endian;
 }
 
+bool DB::isComponentEnabled(Component comp) const
+{
+    auto idx = static_cast<std::size_t>(comp);
+    assert(idx < m_components.size());
+    return m_components[idx];
+}
+
+bool DB::hasExplicitInstantiation() const
+{
+    return !m_instantiateOptions.empty();
+}
+
+const std::string& DB::getInstantiateOptions() const
+{
+    return m_instantiateOptions;
+}
+
+bool DB::isLazyReadEnabled() const
+{
+    return m_lazyRead;
+}
+
+bool DB::isViewEnabled() const
+{
+    return m_views;
+}
+
+bool DB::isEncoderEnabled() const
+{
+    return m_encoders;
+}
+
 bool DB::doesElementExist(unsigned introducedSince) const
 {
     return (introducedSince <= m_schemaVersion);
@@ -327,6 +433,26 @@ bool DB::isGroupListRecorded() const
     return m_groupListUsed;
 }
 
+void DB::recordBoundedGroupStorageUsage()
+{
+    m_boundedGroupStorageUsed = true;
+}
+
+bool DB::isBoundedGroupStorageRecorded() const
+{
+    return m_boundedGroupStorageUsed;
+}
+
+void DB::recordBoundedDataStorageUsage()
+{
+    m_boundedDataStorageUsed = true;
+}
+
+bool DB::isBoundedDataStorageRecorded() const
+{
+    return m_boundedDataStorageUsed;
+}
+
 bool DB::isPaddingRecorded() const
 {
     return !m_paddingTypes.empty();
@@ -354,18 +480,87 @@ xmlNodePtr DB::createMsgIdEnumNode(const std::string& name, const std::string& e
     }
 
     m_msgIdEnum = xmlEnumValidValue(name, encType, values);
+    m_msgIdEncodingType = encType;
     return m_msgIdEnum.get();
 }
 
-xmlNodePtr DB::getMsgIdEnumNode() const
+const std::string& DB::getMsgIdEncodingType() const
 {
     assert(m_msgIdEnum);
-    return m_msgIdEnum.get();
+    return m_msgIdEncodingType;
+}
+
+std::uint64_t DB::getTypeFingerprint(const std::string& name)
+{
+    auto iter = m_typeFingerprints.find(name);
+    if (iter != m_typeFingerprints.end()) {
+        return iter->second;
+    }
+
+    auto* type = findType(name);
+    if (type == nullptr) {
+        return 0U;
+    }
+
+    // Guard against recursive references
+    m_typeFingerprints[name] = 0U;
+
+    std::string extra;
+    if ((type->getKind() == Type::Kind::Composite) &&
+        (asCompositeType(type)->dataUseRecorded())) {
+        extra = "dataUse";
+    }
+
+    auto value = computeFingerprint(type->getNode(), std::move(extra));
+    m_typeFingerprints[name] = value;
+    return value;
+}
+
+std::uint64_t DB::getMessageFingerprint(const Message& msg)
+{
+    auto iter = m_messageFingerprints.find(msg.getName());
+    if (iter != m_messageFingerprints.end()) {
+        return iter->second;
+    }
+
+    auto value = computeFingerprint(msg.getNode());
+    m_messageFingerprints[msg.getName()] = value;
+    return value;
+}
+
+std::uint64_t DB::getSchemaFingerprint()
+{
+    auto contents = getGlobalFingerprint();
+    for (auto& t : m_types) {
+        contents += '\n' + t.first + ':' + std::to_string(getTypeFingerprint(t.first));
+    }
+
+    for (auto& m : m_messages) {
+        assert(m.second);
+        contents += '\n' + m.first + ':' + std::to_string(getMessageFingerprint(*m.second));
+    }
+    return GeneratedFiles::hash(contents);
+}
+
+bool DB::isTransportType(const std::string& name)
+{
+    if (!m_transportTypes) {
+        m_transportTypes.reset(new NamesSet);
+        collectTypeDeps(getMessageHeaderType(), *m_transportTypes);
+        collectTypeDeps(m_openFramingHeaderName, *m_transportTypes);
+    }
+
+    return m_transportTypes->find(name) != m_transportTypes->end();
 }
 
 bool DB::recordTypeRef(xmlNodePtr node)
 {
-    auto props = xmlParseNodeProps(node, m_doc.get());
+    auto ptr = Type::create(*this, node);
+    if (!ptr) {
+        return false;
+    }
+
+    auto& props = ptr->getProps();
     auto& name = prop::name(props);
 
     if (name.empty()) {
@@ -380,11 +575,6 @@ bool DB::recordTypeRef(xmlNodePtr node)
         return false;
     }
 
-    auto ptr = Type::create(*this, node);
-    if (!ptr) {
-        return false;
-    }
-
     if (doesElementExist(prop::sinceVersion(props))) {
         m_types.insert(std::make_pair(name, std::move(ptr)));
     }
@@ -410,7 +600,8 @@ bool DB::parseTypes(xmlNodePtr node)
 
 bool DB::parseMessage(xmlNodePtr node)
 {
-    auto props = xmlParseNodeProps(node, m_doc.get());
+    std::unique_ptr<Message> msg(new Message(*this, node));
+    auto& props = msg->getProps();
     auto& name = prop::name(props);
     if (name.empty()) {
         log::error() << "message element does NOT have name property" << std::endl;
@@ -427,7 +618,10 @@ bool DB::parseMessage(xmlNodePtr node)
         return true;
     }
 
-    std::unique_ptr<Message> msg(new Message(*this, node));
+    if (!isMessageSelected(name)) {
+        return true;
+    }
+
     auto id = prop::id(props);
     auto iterById = m_messagesById.find(id);
     if (iterById != m_messagesById.end()) {
@@ -435,7 +629,7 @@ bool DB::parseMessage(xmlNodePtr node)
         return false;
     }
 
-    auto insertIter = m_messages.insert(m_messages.end(), std::make_pair(name, std::move(msg)));
+    auto insertIter = m_messages.insert(m_messages.end(), std::make_pair(std::string(name), std::move(msg)));
     assert(insertIter != m_messages.end());
     m_messagesById.insert(std::make_pair(id, insertIter));
 
@@ -445,30 +639,17 @@ bool DB::parseMessage(xmlNodePtr node)
 bool DB::processOptions(const ProgramOptions& options)
 {
     return
-        processOutputDirectory(options) &&
         processNamespace(options) &&
         processForcedSchemaVersion(options) &&
         processMinRemoteVersion(options) &&
         processCommsChampionTag(options) &&
-        processOpenFramingHeader(options);
-}
-
-bool DB::processOutputDirectory(const ProgramOptions& options)
-{
-    auto dir = options.getOutputDirectory();
-    if (dir.empty()) {
-        m_rootDir = bf::current_path().string();
-        return true;
-    }
-
-    bf::path dirPath(dir);
-    if (dirPath.is_absolute()) {
-        m_rootDir = dir;
-        return true;
-    }
-
-    m_rootDir = (bf::current_path() / dirPath).string();
-    return true;
+        processOpenFramingHeader(options) &&
+        processMessagesFilter(options) &&
+        processComponents(options) &&
+        processInstantiateOptions(options) &&
+        processLazyRead(options) &&
+        processViews(options) &&
+        processEncoders(options);
 }
 
 bool DB::processNamespace(const ProgramOptions& options)
@@ -532,6 +713,81 @@ bool DB::processOpenFramingHeader(const ProgramOptions& options)
     return true;
 }
 
+bool DB::processMessagesFilter(const ProgramOptions& options)
+{
+    m_messagesFilter = options.getMessages();
+    return true;
+}
+
+bool DB::processComponents(const ProgramOptions& options)
+{
+    auto names = options.getComponents();
+    if (names.empty()) {
+        m_components.fill(true);
+        return true;
+    }
+
+    for (auto& n : names) {
+        auto begIter = std::begin(ComponentNames);
+        auto endIter = std::end(ComponentNames);
+        auto iter = std::find(begIter, endIter, n);
+        if (iter == endIter) {
+            log::error() << "Unknown component \"" << n << "\"." << std::endl;
+            return false;
+        }
+
+        enableComponent(static_cast<Component>(std::distance(begIter, iter)));
+    }
+    return true;
+}
+
+bool DB::processInstantiateOptions(const ProgramOptions& options)
+{
+    if (!options.hasInstantiateOptions()) {
+        return true;
+    }
+
+    m_instantiateOptions = options.getInstantiateOptions();
+    ba::trim(m_instantiateOptions);
+    if (m_instantiateOptions.empty()) {
+        log::error() << "Empty list of the interface options to instantiate the messages with." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool DB::processLazyRead(const ProgramOptions& options)
+{
+    m_lazyRead = options.lazyReadRequested();
+    return true;
+}
+
+bool DB::processViews(const ProgramOptions& options)
+{
+    // The validated lazy read of the messages is implemented using their views
+    m_views = options.viewsRequested() || m_lazyRead;
+    return true;
+}
+
+bool DB::processEncoders(const ProgramOptions& options)
+{
+    m_encoders = options.encodersRequested();
+    return true;
+}
+
+void DB::enableComponent(Component comp)
+{
+    auto idx = static_cast<std::size_t>(comp);
+    if (m_components[idx]) {
+        return;
+    }
+
+    m_components[idx] = true;
+    for (auto d : ComponentDeps[idx]) {
+        enableComponent(d);
+    }
+}
+
 bool DB::processMessageSchema()
 {
     assert(m_messageSchema);
@@ -547,6 +803,139 @@ bool DB::processMessageSchema()
     return true;
 }
 
+const std::string& DB::getGlobalFingerprint()
+{
+    if (!m_globalFingerprint.empty()) {
+        return m_globalFingerprint;
+    }
+
+    std::ostringstream stream;
+    stream << GeneratorBuildStamp << '\n' <<
+              m_namespace << '\n' <<
+              m_schemaVersion << '\n' <<
+              m_minRemoteVersion << '\n' <<
+              m_commsChampionTag << '\n' <<
+              m_openFramingHeaderName << '\n' <<
+              m_instantiateOptions << '\n' <<
+              m_lazyRead << '\n' <<
+              m_views << '\n' <<
+              m_encoders << '\n';
+
+    // Selection of the components changes the contents of the shared files
+    for (auto idx = 0U; idx < m_components.size(); ++idx) {
+        if (m_components[idx]) {
+            stream << ComponentNames[idx] << ' ';
+        }
+    }
+    stream << '\n';
+
+    auto* root = xmlDocGetRootElement(m_doc.get());
+    assert(root != nullptr);
+    auto rootProps = xmlParseNodeProps(root, m_doc.get());
+    for (auto& p : rootProps) {
+        stream << p.first << '=' << p.second << '\n';
+    }
+
+    m_globalFingerprint = stream.str();
+    return m_globalFingerprint;
+}
+
+std::uint64_t DB::computeFingerprint(xmlNodePtr node, std::string extra)
+{
+    NamesSet refs;
+    collectTypeRefs(node, refs);
+
+    auto contents = getGlobalFingerprint();
+    contents += xmlDump(node, m_doc.get());
+    contents += extra;
+    for (auto& r : refs) {
+        contents += '\n' + r + ':' + std::to_string(getTypeFingerprint(r));
+    }
+    return GeneratedFiles::hash(contents);
+}
+
+void DB::collectTypeRefs(xmlNodePtr node, NamesSet& refs) const
+{
+    auto props = xmlParseNodeProps(node, m_doc.get());
+    for (auto& p : TypeRefProps) {
+        auto iter = props.find(p);
+        if (iter == props.end()) {
+            continue;
+        }
+
+        auto name = iter->second.substr(0, iter->second.find('.'));
+        if (findType(name) != nullptr) {
+            refs.insert(std::move(name));
+        }
+    }
+
+    static const std::string GroupStr("group");
+    if ((GroupStr == reinterpret_cast<const char*>(node->name)) &&
+        (findType(prop::dimensionType(props)) != nullptr)) {
+        refs.insert(prop::dimensionType(props));
+    }
+
+    for (auto* c : xmlChildren(node)) {
+        collectTypeRefs(c, refs);
+    }
+}
+
+bool DB::isMessageSelected(const std::string& name) const
+{
+    if (m_messagesFilter.empty()) {
+        return true;
+    }
+
+    return
+        std::any_of(
+            m_messagesFilter.begin(), m_messagesFilter.end(),
+            [&name](const std::string& f)
+            {
+                return common::wildcardMatch(f, name);
+            });
+}
+
+void DB::pruneUnusedTypes()
+{
+    NamesSet used;
+    collectTypeDeps(getMessageHeaderType(), used);
+    collectTypeDeps(m_openFramingHeaderName, used);
+    for (auto& m : m_messages) {
+        assert(m.second);
+        NamesSet refs;
+        collectTypeRefs(m.second->getNode(), refs);
+        for (auto& r : refs) {
+            collectTypeDeps(r, used);
+        }
+    }
+
+    auto iter = m_types.begin();
+    while (iter != m_types.end()) {
+        if (used.find(iter->first) != used.end()) {
+            ++iter;
+            continue;
+        }
+
+        log::info() << "Skipping unused type \"" << iter->first << "\"" << std::endl;
+        iter = m_types.erase(iter);
+    }
+}
+
+void DB::collectTypeDeps(const std::string& name, NamesSet& deps)
+{
+    auto* type = findType(name);
+    if ((type == nullptr) || (deps.find(name) != deps.end())) {
+        return;
+    }
+
+    deps.insert(name);
+    NamesSet refs;
+    collectTypeRefs(type->getNode(), refs);
+    for (auto& r : refs) {
+        collectTypeDeps(r, deps);
+    }
+}
+
 void DB::checkOpenFramingHeader()
 {
     auto& name = getSimpleOpenFramingHeaderTypeName();
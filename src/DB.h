@@ -18,16 +18,24 @@
 #pragma once
 
 #include <map>
+#include <array>
+#include <unordered_map>
 #include <list>
 #include <string>
+#include <set>
+#include <vector>
+#include <cstdint>
 
 #include <boost/optional.hpp>
 
 #include "xml_wrap.h"
+#include "IndexedMap.h"
 #include "MessageSchema.h"
 #include "Type.h"
 #include "Message.h"
 #include "ProgramOptions.h"
+#include "GeneratedFiles.h"
+#include "OutputSink.h"
 
 namespace sbe2comms
 {
@@ -35,12 +43,28 @@ namespace sbe2comms
 class DB
 {
 public:
-    using TypesMap = std::map<std::string, TypePtr>;
+    using TypesMap = IndexedMap<TypePtr>;
     using MessagePtr = std::unique_ptr<Message>;
-    using MessagesMap = std::map<std::string, MessagePtr>;
+    using MessagesMap = IndexedMap<MessagePtr>;
     using MessagesIdMap = std::map<unsigned, MessagesMap::const_iterator>;
 
-    bool parseSchema(const ProgramOptions& options);
+    /// \brief Independently selectable parts of the generated output.
+    enum class Component
+    {
+        Protocol,
+        Plugin,
+        Doc,
+        Cmake,
+        NumOfValues
+    };
+
+    explicit DB(OutputSink& sink);
+
+    /// \brief Build the types and messages of the parsed schema.
+    /// \details The model refers to the element nodes of the document,
+    ///     which is owned until the object is destroyed. The generated
+    ///     padding, built-in and message ID types are kept outside of it.
+    bool parseSchema(const ProgramOptions& options, XmlDocPtr doc);
 
     xmlDocPtr getDoc()
     {
@@ -67,7 +91,14 @@ public:
         return m_messagesById;
     }
 
+    /// \brief Directory of the generated files inside the output sink.
     const std::string& getRootPath() const;
+    void setRootPath(const std::string& path);
+
+    GeneratedFiles& getGeneratedFiles()
+    {
+        return m_generatedFiles;
+    }
 
     const std::string& getProtocolNamespace() const;
 
@@ -89,6 +120,23 @@ public:
 
     const std::string& getEndian() const;
 
+    bool isComponentEnabled(Component comp) const;
+
+    /// \brief Whether the messages are explicitly instantiated.
+    bool hasExplicitInstantiation() const;
+
+    /// \brief Options of the interface class used for explicit instantiation.
+    const std::string& getInstantiateOptions() const;
+
+    /// \brief Whether the messages support lazy read of the groups and data fields.
+    bool isLazyReadEnabled() const;
+
+    /// \brief Whether the zero-copy views of the messages are generated.
+    bool isViewEnabled() const;
+
+    /// \brief Whether the flyweight encoders of the messages are generated.
+    bool isEncoderEnabled() const;
+
     bool doesElementExist(unsigned introducedSince) const;
 
     const Type* findType(const std::string& name) const;
@@ -112,12 +160,23 @@ public:
     void recordGroupListUsage();
     bool isGroupListRecorded() const;
 
+    void recordBoundedGroupStorageUsage();
+    bool isBoundedGroupStorageRecorded() const;
+
+    void recordBoundedDataStorageUsage();
+    bool isBoundedDataStorageRecorded() const;
+
     bool isPaddingRecorded() const;
 
     std::list<std::string> getAllUsedBuiltInTypes() const;
 
     xmlNodePtr createMsgIdEnumNode(const std::string& name, const std::string& encType);
-    xmlNodePtr getMsgIdEnumNode() const;
+    const std::string& getMsgIdEncodingType() const;
+
+    std::uint64_t getTypeFingerprint(const std::string& name);
+    std::uint64_t getMessageFingerprint(const Message& msg);
+    std::uint64_t getSchemaFingerprint();
+    bool isTransportType(const std::string& name);
 
 private:
     struct GeneratedTypeInfo
@@ -126,24 +185,39 @@ private:
         TypePtr m_type;
     };
 
-    using GeneratedTypeMap = std::map<std::string, GeneratedTypeInfo>;
+    using GeneratedTypeMap = IndexedMap<GeneratedTypeInfo>;
+    using FingerprintsMap = std::unordered_map<std::string, std::uint64_t>;
+    using NamesSet = std::set<std::string>;
 
     bool recordTypeRef(xmlNodePtr node);
     bool parseTypes(xmlNodePtr node);
     bool parseMessage(xmlNodePtr node);
     bool processOptions(const ProgramOptions& options);
-    bool processOutputDirectory(const ProgramOptions& options);
     bool processNamespace(const ProgramOptions& options);
     bool processForcedSchemaVersion(const ProgramOptions& options);
     bool processMinRemoteVersion(const ProgramOptions& options);
     bool processCommsChampionTag(const ProgramOptions& options);
     bool processOpenFramingHeader(const ProgramOptions& options);
+    bool processMessagesFilter(const ProgramOptions& options);
+    bool processComponents(const ProgramOptions& options);
+    bool processInstantiateOptions(const ProgramOptions& options);
+    bool processLazyRead(const ProgramOptions& options);
+    bool processViews(const ProgramOptions& options);
+    bool processEncoders(const ProgramOptions& options);
+    void enableComponent(Component comp);
     bool processMessageSchema();
     void checkOpenFramingHeader();
+    const std::string& getGlobalFingerprint();
+    std::uint64_t computeFingerprint(xmlNodePtr node, std::string extra = std::string());
+    void collectTypeRefs(xmlNodePtr node, NamesSet& refs) const;
+    void collectTypeDeps(const std::string& name, NamesSet& deps);
+    bool isMessageSelected(const std::string& name) const;
+    void pruneUnusedTypes();
 
     XmlDocPtr m_doc;
     std::unique_ptr<MessageSchema> m_messageSchema;
     XmlNodePtr m_msgIdEnum;
+    std::string m_msgIdEncodingType;
     TypesMap m_types;
     GeneratedTypeMap m_builtInTypes;
     GeneratedTypeMap m_paddingTypes;
@@ -151,6 +225,8 @@ private:
     MessagesIdMap m_messagesById;
     std::list<std::string> m_groups;
     bool m_groupListUsed = false;
+    bool m_boundedGroupStorageUsed = false;
+    bool m_boundedDataStorageUsed = false;
     std::string m_rootDir;
     std::string m_endian;
     std::string m_namespace;
@@ -158,6 +234,17 @@ private:
     unsigned m_minRemoteVersion = 0U;
     std::string m_commsChampionTag;
     std::string m_openFramingHeaderName;
+    GeneratedFiles m_generatedFiles;
+    std::string m_globalFingerprint;
+    FingerprintsMap m_typeFingerprints;
+    FingerprintsMap m_messageFingerprints;
+    std::unique_ptr<NamesSet> m_transportTypes;
+    std::vector<std::string> m_messagesFilter;
+    std::array<bool, static_cast<std::size_t>(Component::NumOfValues)> m_components;
+    std::string m_instantiateOptions;
+    bool m_lazyRead = false;
+    bool m_views = false;
+    bool m_encoders = false;
 };
 
 } // namespace sbe2comms
@@ -70,6 +70,10 @@ bool DataField::parseImpl()
     }
 
     compType->recordDataUse();
+    if (compType->getMaxDataLength() != 0U) {
+        getDb().recordBoundedDataStorageUsage();
+    }
+
     m_type = typePtr;
     recordExtraHeader(common::localHeader(getDb().getProtocolNamespace(), common::fieldNamespaceNameStr(), m_type->getName() + ".h"));
     return true;
@@ -97,7 +101,15 @@ bool DataField::writeImpl(std::ostream& out, unsigned indent, const std::string&
         }
         out << o.second << ",\n";
     }
-    out << output::indent(indent + 2) << getFieldOptString() << '\n' <<
+    out << output::indent(indent + 2) << getFieldOptString();
+
+    auto maxLength = asCompositeType(m_type)->getMaxDataLength();
+    if (maxLength != 0U) {
+        out << ",\n" <<
+               output::indent(indent + 2) << common::optParamPrefixStr() << "template " << common::boundedDataStorageStr() << '<' << maxLength << '>';
+    }
+
+    out << '\n' <<
            output::indent(indent + 1) << ">;\n\n";
     return true;
 }
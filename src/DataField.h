@@ -29,6 +29,11 @@ class DataField : public Field
 public:
     DataField(DB& db, xmlNodePtr node, const std::string& msgName) : Base(db, node, msgName) {}
 
+    const Type* getReferencedType() const
+    {
+        return m_type;
+    }
+
 protected:
     virtual Kind getKindImpl() const override;
     virtual unsigned getReferencedTypeSinceVersionImpl() const override;
@@ -18,7 +18,6 @@
 #include "Doxygen.h"
 
 #include <iostream>
-#include <fstream>
 //#include <algorithm>
 
 #include <boost/filesystem.hpp>
@@ -28,6 +27,7 @@
 #include "output.h"
 #include "DB.h"
 #include "log.h"
+#include "OutputFile.h"
 
 namespace bf = boost::filesystem;
 namespace ba = boost::algorithm;
@@ -49,16 +49,6 @@ Doxygen::Doxygen(DB& db)
 
 bool Doxygen::write()
 {
-    boost::system::error_code ec;
-    auto dir = bf::path(m_db.getRootPath()) / DocDirName;
-    bf::create_directories(dir, ec);
-    if (ec) {
-        log::error() << "Failed to create \"" << dir.string() <<
-                "\" with error \"" << ec.message() << "\"!" << std::endl;
-        return false;
-    }
-
-
     return writeLayout() && writeConf() && writeNamespaces() && writeMain();
 }
 
@@ -67,7 +57,7 @@ bool Doxygen::writeLayout()
     auto relPath = DocDirName + '/' + "layout.xml";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -256,7 +246,7 @@ bool Doxygen::writeLayout()
            "    <detaileddescription title=\"\"/>\n"
            "  </directory>\n"
            "</doxygenlayout>\n";
-    return true;
+    return out.commit();
 }
 
 bool Doxygen::writeConf()
@@ -264,7 +254,7 @@ bool Doxygen::writeConf()
     auto relPath = DocDirName + '/' + "doxygen.conf";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -412,7 +402,7 @@ bool Doxygen::writeConf()
            "HIDE_UNDOC_RELATIONS   = YES\n"
            "HAVE_DOT               = NO\n";
 
-    return true;
+    return out.commit();
 }
 
 bool Doxygen::writeNamespaces()
@@ -426,7 +416,7 @@ bool Doxygen::writeNamespaces()
     auto relPath = DocDirName + '/' + nsFile;
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -443,7 +433,7 @@ bool Doxygen::writeNamespaces()
            "/// \\brief Namespace for all the stand alone fields defined in this protocol.\n\n"
            "/// \\namespace " << common::scopeFor(ns, common::builtinNamespaceNameStr()) << "\n"
            "/// \\brief Namespace for all implicitly defined (built-in) fields.\n\n";
-    return true;
+    return out.commit();
 }
 
 bool Doxygen::writeMain()
@@ -451,7 +441,7 @@ bool Doxygen::writeMain()
     auto relPath = DocDirName + "/main.dox";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -2383,7 +2373,7 @@ bool Doxygen::writeMain()
            "/// \\b padX_ (with \\b _ suffix) format where \\b X is a sequential\n"
            "/// number of the padding field.\n"
            "///\n\n";
-    return true;
+    return out.commit();
 }
 
 
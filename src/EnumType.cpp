@@ -425,7 +425,7 @@ const std::string& EnumType::getUnderlyingType() const
 
 bool EnumType::readValues()
 {
-    static const std::string ElementStr("validValue");
+    static const char* ElementStr = "validValue";
     auto vals = xmlChildren(getNode(), ElementStr);
     if (vals.empty()) {
         log::error() << "No validValue has been specified for enum \"" << getName() << "\"" << std::endl;
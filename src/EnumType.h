@@ -34,6 +34,7 @@ public:
     bool hasValue(const std::string& name) const;
     std::intmax_t getNumericValue(const std::string& name) const;
     std::intmax_t getDefultNullValue() const;
+    const std::string& getUnderlyingType() const;
     void setMessageId()
     {
         m_msgId = true;
@@ -68,7 +69,6 @@ private:
         unsigned indent,
         unsigned count,
         bool commsOptionalWrapped);
-    const std::string& getUnderlyingType() const;
     bool readValues();
     RangeInfosList getValidRanges() const;
     Values::const_iterator findValue(const std::string& name) const;
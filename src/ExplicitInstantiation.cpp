@@ -0,0 +1,149 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "ExplicitInstantiation.h"
+
+#include <cassert>
+
+#include <boost/filesystem.hpp>
+
+#include "DB.h"
+#include "common.h"
+#include "log.h"
+#include "OutputFile.h"
+#include "output.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+std::string interfaceType(const DB& db)
+{
+    return common::msgInterfaceStr() + '<' + db.getInstantiateOptions() + '>';
+}
+
+} // namespace
+
+bool ExplicitInstantiation::write()
+{
+    assert(m_db.hasExplicitInstantiation());
+    if ((!writeDeclarations()) || (!writeInterfaceDef())) {
+        return false;
+    }
+
+    for (auto& m : m_db.getMessagesById()) {
+        if (!writeMessageDef(m.second->first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ExplicitInstantiation::writeDeclarations()
+{
+    auto& ns = m_db.getProtocolNamespace();
+    auto relPath = common::protocolDirRelPath(ns, common::instantiatedMessagesFileName());
+    auto filePath = bf::path(m_db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(m_db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    out << "/// \\file\n"
+           "/// \\brief Contains extern template declarations of all the messages\n"
+           "///     explicitly instantiated for \\ref " << common::scopeFor(ns, common::instantiatedMessageStr()) << " interface.\n"
+           "/// \\details Include this file instead of \\b " << common::pathTo(ns, common::allMessagesFileName()) << " and link\n"
+           "///     to the messages library to avoid instantiation of the messages\n"
+           "///     in every translation unit.\n"
+           "/// \\note Only the message classes and the interface are instantiated\n"
+           "///     explicitly, their \\b comms::MessageBase bases and the fields\n"
+           "///     are still instantiated implicitly where used.\n\n"
+           "#pragma once\n\n"
+           "#include " << common::localHeader(ns, common::msgInterfaceFileName()) << "\n"
+           "#include " << common::localHeader(ns, common::allMessagesFileName()) << "\n\n";
+
+    common::writeProtocolNamespaceBegin(ns, out);
+
+    out << "/// \\brief Common interface class all the messages are explicitly instantiated for.\n"
+           "using " << common::instantiatedMessageStr() << " = " << interfaceType(m_db) << ";\n\n"
+           "/// \\brief All the protocol messages explicitly instantiated for\n"
+           "///     \\ref " << common::instantiatedMessageStr() << " interface bundled in std::tuple.\n"
+           "using " << common::instantiatedMessageStr() << "s = " << common::allMessagesStr() << '<' << common::instantiatedMessageStr() << ">;\n\n"
+           "extern template class " << interfaceType(m_db) << ";\n";
+
+    for (auto& m : m_db.getMessagesById()) {
+        out << "extern template class " << common::messageNamespaceStr() << m.second->first << '<' << common::instantiatedMessageStr() << ">;\n";
+    }
+    out << '\n';
+
+    common::writeProtocolNamespaceEnd(ns, out);
+    return out.commit();
+}
+
+bool ExplicitInstantiation::writeInterfaceDef()
+{
+    auto& ns = m_db.getProtocolNamespace();
+    auto relPath = common::srcDirName() + '/' + common::msgInterfaceStr() + ".cpp";
+    auto filePath = bf::path(m_db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(m_db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    out << "/// \\file\n"
+           "/// \\brief Contains explicit instantiation of \\ref " << common::scopeFor(ns, common::instantiatedMessageStr()) << " interface class.\n\n"
+           "#include " << common::localHeader(ns, common::instantiatedMessagesFileName()) << "\n\n";
+
+    common::writeProtocolNamespaceBegin(ns, out);
+    out << "template class " << interfaceType(m_db) << ";\n\n";
+    common::writeProtocolNamespaceEnd(ns, out);
+    return out.commit();
+}
+
+bool ExplicitInstantiation::writeMessageDef(const std::string& name)
+{
+    auto& ns = m_db.getProtocolNamespace();
+    auto relPath = common::srcDirName() + '/' + common::messageNamespaceNameStr() + '/' + name + ".cpp";
+    auto filePath = bf::path(m_db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(m_db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    out << "/// \\file\n"
+           "/// \\brief Contains explicit instantiation of \\ref " << common::scopeFor(ns, common::messageNamespaceStr() + name) << " message\n"
+           "///     for \\ref " << common::scopeFor(ns, common::instantiatedMessageStr()) << " interface.\n\n"
+           "#include " << common::localHeader(ns, common::instantiatedMessagesFileName()) << "\n\n";
+
+    common::writeProtocolNamespaceBegin(ns, out);
+    out << "template class " << common::messageNamespaceStr() << name << '<' << common::instantiatedMessageStr() << ">;\n\n";
+    common::writeProtocolNamespaceEnd(ns, out);
+    return out.commit();
+}
+
+} // namespace sbe2comms
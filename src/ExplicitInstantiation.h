@@ -0,0 +1,45 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <string>
+
+namespace sbe2comms
+{
+
+class DB;
+
+/// \brief Writes explicit instantiation of all the messages for the
+///     interface class selected with "--instantiate" option.
+class ExplicitInstantiation
+{
+public:
+    ExplicitInstantiation(DB& db) : m_db(db) {}
+
+    bool write();
+
+private:
+    bool writeDeclarations();
+    bool writeInterfaceDef();
+    bool writeMessageDef(const std::string& name);
+
+    DB& m_db;
+};
+
+} // namespace sbe2comms
@@ -17,12 +17,12 @@
 
 #include "FieldBase.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -70,10 +70,6 @@ bool FieldBase::write()
 
 bool FieldBase::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace(), common::fieldDirName())) {
-        return false;
-    }
-
     auto fieldDirRelPath =
             common::protocolDirRelPath(m_db.getProtocolNamespace(), common::fieldDirName());
 
@@ -82,7 +78,7 @@ bool FieldBase::writeProtocolDef()
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
 
     log::info() << "Generating " << relPath.string() << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -93,7 +89,7 @@ bool FieldBase::writeProtocolDef()
     out << "/// \\brief Definition of common base class of all the fields.\n"
            "using " << common::fieldBaseStr() << " = comms::Field<" << m_db.getEndian() << ">;\n\n";
     closeNamespaces(out, m_db);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
@@ -0,0 +1,121 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "FilesystemSink.h"
+
+#include <fstream>
+#include <iterator>
+
+#include <boost/filesystem.hpp>
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+FilesystemSink::FilesystemSink(const std::string& dir)
+{
+    do {
+        if (dir.empty()) {
+            m_dir = bf::current_path().string();
+            break;
+        }
+
+        bf::path dirPath(dir);
+        if (dirPath.is_absolute()) {
+            m_dir = dir;
+            break;
+        }
+
+        m_dir = (bf::current_path() / dirPath).string();
+    } while (false);
+}
+
+FilesystemSink::~FilesystemSink() noexcept = default;
+
+bool FilesystemSink::existsImpl(const std::string& path)
+{
+    boost::system::error_code ec;
+    return bf::exists(fullPath(path), ec);
+}
+
+bool FilesystemSink::readImpl(const std::string& path, std::string& contents)
+{
+    std::ifstream stream(fullPath(path));
+    if (!stream) {
+        return false;
+    }
+
+    contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return !stream.bad();
+}
+
+bool FilesystemSink::writeImpl(const std::string& path, const std::string& contents)
+{
+    bf::path filePath(fullPath(path));
+    boost::system::error_code ec;
+    bf::create_directories(filePath.parent_path(), ec);
+    if (ec) {
+        return false;
+    }
+
+    std::ofstream stream(filePath.string());
+    stream << contents;
+    stream.flush();
+    return stream.good();
+}
+
+bool FilesystemSink::removeImpl(const std::string& path)
+{
+    boost::system::error_code ec;
+    if (!bf::remove(fullPath(path), ec)) {
+        return false;
+    }
+
+    // Don't leave behind the directories, which became empty,
+    // but never go above the output directory.
+    auto dir = bf::path(path).parent_path();
+    while ((!dir.empty()) && dir.is_relative()) {
+        bf::path dirPath(fullPath(dir.string()));
+        if ((!bf::is_empty(dirPath, ec)) || ec) {
+            break;
+        }
+
+        if ((!bf::remove(dirPath, ec)) || ec) {
+            break;
+        }
+
+        dir = dir.parent_path();
+    }
+    return true;
+}
+
+std::string FilesystemSink::locationImpl(const std::string& path) const
+{
+    return fullPath(path);
+}
+
+std::string FilesystemSink::fullPath(const std::string& path) const
+{
+    if (path.empty()) {
+        return m_dir;
+    }
+
+    return (bf::path(m_dir) / path).string();
+}
+
+} // namespace sbe2comms
@@ -0,0 +1,47 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "OutputSink.h"
+
+namespace sbe2comms
+{
+
+/// \brief Writes the generated files into the directory on the disk.
+class FilesystemSink : public OutputSink
+{
+public:
+    /// \brief Constructor.
+    /// \param[in] dir Output directory, empty means current.
+    explicit FilesystemSink(const std::string& dir);
+    ~FilesystemSink() noexcept;
+
+protected:
+    virtual bool existsImpl(const std::string& path) override;
+    virtual bool readImpl(const std::string& path, std::string& contents) override;
+    virtual bool writeImpl(const std::string& path, const std::string& contents) override;
+    virtual bool removeImpl(const std::string& path) override;
+    virtual std::string locationImpl(const std::string& path) const override;
+
+private:
+    std::string fullPath(const std::string& path) const;
+
+    std::string m_dir;
+};
+
+} // namespace sbe2comms
@@ -0,0 +1,350 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "GeneratedFiles.h"
+
+#include <sstream>
+#include <iomanip>
+#include <cassert>
+
+#include <boost/filesystem.hpp>
+
+#include "log.h"
+#include "stats.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+const std::string ManifestFileName(".sbe2comms_manifest");
+const std::string ManifestHeader("# sbe2comms generated files manifest");
+const char ElementPrefix = '@';
+
+thread_local GeneratedFiles::FilesList* CurrentElementFiles = nullptr;
+
+void writeHash(std::ostream& out, std::uint64_t value)
+{
+    out << std::hex << std::setw(16) << std::setfill('0') << value << std::dec;
+}
+
+} // namespace
+
+GeneratedFiles::GeneratedFiles(OutputSink& sink)
+  : m_sink(sink)
+{
+}
+
+GeneratedFiles::ElementScope::ElementScope(
+    GeneratedFiles& files,
+    const std::string& element,
+    std::uint64_t fingerprint)
+  : m_files(files),
+    m_element(element),
+    m_fingerprint(fingerprint),
+    m_prevGenerated(CurrentElementFiles)
+{
+    CurrentElementFiles = &m_generated;
+}
+
+GeneratedFiles::ElementScope::~ElementScope() noexcept
+{
+    CurrentElementFiles = m_prevGenerated;
+}
+
+bool GeneratedFiles::ElementScope::complete(bool success)
+{
+    if (success) {
+        m_files.recordElement(m_element, m_fingerprint, std::move(m_generated));
+    }
+    return success;
+}
+
+void GeneratedFiles::setRootPath(const std::string& path)
+{
+    m_rootDir = path;
+    readManifest();
+}
+
+void GeneratedFiles::resume(const GeneratedFiles& prev)
+{
+    assert(m_rootDir == prev.m_rootDir);
+    m_prevFiles = prev.m_files;
+    m_prevElements = prev.m_elements;
+    m_resumed = true;
+}
+
+bool GeneratedFiles::commit(const std::string& filePath, const std::string& contents)
+{
+    enum class Status
+    {
+        Added,
+        Changed,
+        Unchanged
+    };
+
+    auto sinkPath = bf::path(filePath).generic_string();
+    auto relPath = relPathOf(filePath);
+    auto contentsHash = hash(contents);
+    auto status = Status::Added;
+    do {
+        if (!m_sink.exists(sinkPath)) {
+            break;
+        }
+
+        status = Status::Changed;
+        if (m_resumed) {
+            auto iter = m_prevFiles.find(relPath);
+            if ((iter != m_prevFiles.end()) && (iter->second == contentsHash)) {
+                status = Status::Unchanged;
+            }
+            break;
+        }
+
+        std::string existing;
+        if (m_sink.read(sinkPath, existing) && (existing == contents)) {
+            status = Status::Unchanged;
+        }
+    } while (false);
+
+    bool written = true;
+    std::size_t writtenBytes = 0U;
+    if (status != Status::Unchanged) {
+        written = m_sink.write(sinkPath, contents);
+        writtenBytes = contents.size();
+    }
+
+    stats::recordOutput(contents.size(), writtenBytes);
+
+    if (CurrentElementFiles != nullptr) {
+        CurrentElementFiles->push_back(relPath);
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (!written) {
+        log::error() << "Failed to write " << m_sink.location(sinkPath) << std::endl;
+        m_failed = true;
+        return false;
+    }
+
+    m_files[relPath] = contentsHash;
+    switch (status) {
+    case Status::Added: ++m_added; break;
+    case Status::Changed: ++m_changed; break;
+    default: ++m_unchanged; break;
+    }
+    return true;
+}
+
+bool GeneratedFiles::finalize(bool success)
+{
+    success = success && (!m_failed);
+
+    unsigned removed = 0U;
+    for (auto& f : m_prevFiles) {
+        if (m_files.find(f.first) != m_files.end()) {
+            continue;
+        }
+
+        if (!success) {
+            // Keep tracking files of the previous run until the
+            // generation succeeds.
+            m_files.insert(f);
+            continue;
+        }
+
+        if (m_sink.remove(sinkPathOf(f.first))) {
+            log::info() << "Removing stale " << f.first << std::endl;
+            ++removed;
+        }
+    }
+
+    if (!writeManifest()) {
+        success = false;
+    }
+
+    log::info() << "Files: " <<
+        m_changed << " changed, " <<
+        m_added << " added, " <<
+        m_unchanged << " unchanged, " <<
+        m_kept << " up to date, " <<
+        removed << " removed." << std::endl;
+    return success;
+}
+
+bool GeneratedFiles::isUpToDate(const std::string& element, std::uint64_t fingerprint) const
+{
+    auto iter = m_prevElements.find(element);
+    if ((iter == m_prevElements.end()) ||
+        (iter->second.m_fingerprint != fingerprint)) {
+        return false;
+    }
+
+    for (auto& f : iter->second.m_files) {
+        if (m_prevFiles.find(f) == m_prevFiles.end()) {
+            return false;
+        }
+
+        if (!m_sink.exists(sinkPathOf(f))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GeneratedFiles::keep(const std::string& element)
+{
+    auto iter = m_prevElements.find(element);
+    if (iter == m_prevElements.end()) {
+        assert(!"Keeping unknown element");
+        return false;
+    }
+
+    auto& info = iter->second;
+    for (auto& f : info.m_files) {
+        log::info() << "Up to date " << f << std::endl;
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (auto& f : info.m_files) {
+        auto fileIter = m_prevFiles.find(f);
+        assert(fileIter != m_prevFiles.end());
+        m_files.insert(*fileIter);
+        ++m_kept;
+    }
+
+    m_elements.insert(*iter);
+    return true;
+}
+
+std::uint64_t GeneratedFiles::hash(const std::string& contents)
+{
+    // 64 bit FNV-1a
+    std::uint64_t result = 0xcbf29ce484222325ULL;
+    for (auto c : contents) {
+        result ^= static_cast<std::uint8_t>(c);
+        result *= 0x100000001b3ULL;
+    }
+    return result;
+}
+
+std::string GeneratedFiles::relPathOf(const std::string& filePath) const
+{
+    if (m_rootDir.empty()) {
+        return bf::path(filePath).generic_string();
+    }
+
+    return bf::path(filePath).lexically_relative(m_rootDir).generic_string();
+}
+
+std::string GeneratedFiles::sinkPathOf(const std::string& relPath) const
+{
+    return (bf::path(m_rootDir) / relPath).generic_string();
+}
+
+std::string GeneratedFiles::manifestPath() const
+{
+    return sinkPathOf(ManifestFileName);
+}
+
+void GeneratedFiles::readManifest()
+{
+    std::string contents;
+    if (!m_sink.read(manifestPath(), contents)) {
+        return;
+    }
+
+    std::istringstream stream(contents);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (line.empty() || (line[0] == '#')) {
+            continue;
+        }
+
+        std::istringstream lineStream(line);
+        if (line[0] == ElementPrefix) {
+            std::string element;
+            ElementInfo info;
+            lineStream >> element >> std::hex >> info.m_fingerprint;
+            std::string f;
+            while (lineStream >> f) {
+                info.m_files.push_back(std::move(f));
+            }
+
+            if (1U < element.size()) {
+                m_prevElements[element.substr(1)] = std::move(info);
+            }
+            continue;
+        }
+
+        std::uint64_t value = 0U;
+        std::string relPath;
+        lineStream >> std::hex >> value;
+        std::getline(lineStream >> std::ws, relPath);
+        if (!relPath.empty()) {
+            m_prevFiles[relPath] = value;
+        }
+    }
+}
+
+bool GeneratedFiles::writeManifest() const
+{
+    std::ostringstream out;
+    out << ManifestHeader << '\n';
+    for (auto& f : m_files) {
+        writeHash(out, f.second);
+        out << ' ' << f.first << '\n';
+    }
+
+    for (auto& e : m_elements) {
+        out << ElementPrefix << e.first << ' ';
+        writeHash(out, e.second.m_fingerprint);
+        for (auto& f : e.second.m_files) {
+            out << ' ' << f;
+        }
+        out << '\n';
+    }
+
+    auto filePath = manifestPath();
+    std::string existing;
+    auto contents = out.str();
+    if (m_sink.read(filePath, existing) && (existing == contents)) {
+        return true;
+    }
+
+    if (!m_sink.write(filePath, contents)) {
+        log::error() << "Failed to write " << m_sink.location(filePath) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void GeneratedFiles::recordElement(
+    const std::string& element,
+    std::uint64_t fingerprint,
+    FilesList files)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto& info = m_elements[element];
+    info.m_fingerprint = fingerprint;
+    info.m_files = std::move(files);
+}
+
+} // namespace sbe2comms
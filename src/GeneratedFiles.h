@@ -0,0 +1,110 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+#include "OutputSink.h"
+
+namespace sbe2comms
+{
+
+class GeneratedFiles
+{
+public:
+    using FilesList = std::vector<std::string>;
+
+    /// \brief Records all the files committed by the current thread
+    ///     as generated by the specified schema element.
+    class ElementScope
+    {
+    public:
+        ElementScope(GeneratedFiles& files, const std::string& element, std::uint64_t fingerprint);
+        ~ElementScope() noexcept;
+
+        ElementScope(const ElementScope&) = delete;
+        ElementScope& operator=(const ElementScope&) = delete;
+
+        bool complete(bool success);
+
+    private:
+        GeneratedFiles& m_files;
+        std::string m_element;
+        std::uint64_t m_fingerprint = 0U;
+        FilesList m_generated;
+        FilesList* m_prevGenerated = nullptr;
+    };
+
+    explicit GeneratedFiles(OutputSink& sink);
+
+    /// \brief Set the directory of the generated files inside the sink.
+    void setRootPath(const std::string& path);
+
+    /// \brief Continue from the state of the previous generation into the
+    ///     same directory performed by this process.
+    /// \details The hashes of the files it has written are trusted, the
+    ///     existing files are not read back to check whether their contents
+    ///     have changed.
+    void resume(const GeneratedFiles& prev);
+
+    bool commit(const std::string& filePath, const std::string& contents);
+    bool finalize(bool success);
+
+    bool isUpToDate(const std::string& element, std::uint64_t fingerprint) const;
+    bool keep(const std::string& element);
+
+    static std::uint64_t hash(const std::string& contents);
+
+private:
+    using HashesMap = std::map<std::string, std::uint64_t>;
+
+    struct ElementInfo
+    {
+        std::uint64_t m_fingerprint = 0U;
+        FilesList m_files;
+    };
+
+    using ElementsMap = std::map<std::string, ElementInfo>;
+
+    std::string relPathOf(const std::string& filePath) const;
+    std::string sinkPathOf(const std::string& relPath) const;
+    std::string manifestPath() const;
+    void readManifest();
+    bool writeManifest() const;
+    void recordElement(const std::string& element, std::uint64_t fingerprint, FilesList files);
+
+    std::mutex m_lock;
+    OutputSink& m_sink;
+    std::string m_rootDir;
+    HashesMap m_files;
+    HashesMap m_prevFiles;
+    ElementsMap m_elements;
+    ElementsMap m_prevElements;
+    unsigned m_added = 0U;
+    unsigned m_changed = 0U;
+    unsigned m_unchanged = 0U;
+    unsigned m_kept = 0U;
+    bool m_failed = false;
+    bool m_resumed = false;
+};
+
+} // namespace sbe2comms
@@ -0,0 +1,552 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Generator.h"
+
+#include <set>
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+
+#include <boost/filesystem.hpp>
+
+#include "DB.h"
+#include "BuiltIn.h"
+#include "MsgId.h"
+#include "MsgInterface.h"
+#include "AllMessages.h"
+#include "MsgFactory.h"
+#include "AllFields.h"
+#include "MessageHeaderLayer.h"
+#include "OpenFramingHeaderLayer.h"
+#include "TransportFrame.h"
+#include "FieldBase.h"
+#include "common.h"
+#include "output.h"
+#include "log.h"
+#include "OutputFile.h"
+#include "Cmake.h"
+#include "TransportMessage.h"
+#include "Protocol.h"
+#include "Plugin.h"
+#include "Doxygen.h"
+#include "MessageSchema.h"
+#include "parallel.h"
+#include "stats.h"
+#include "SchemaCache.h"
+#include "ExplicitInstantiation.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+bool writeMessageSchema(DB& db)
+{
+    return MessageSchema::write(db);
+}
+
+bool writeBuiltIn(DB& db)
+{
+    BuiltIn obj(db);
+    return obj.write();
+}
+
+void addElementTask(
+    DB& db,
+    parallel::TasksList& tasks,
+    stats::Kind kind,
+    const std::string& element,
+    std::uint64_t fingerprint,
+    bool canSkip,
+    std::function<bool ()>&& func)
+{
+    auto& files = db.getGeneratedFiles();
+    tasks.push_back(
+        [&files, kind, element, fingerprint, canSkip, func]()
+        {
+            stats::Scope statsScope(kind, element);
+            if (canSkip && files.isUpToDate(element, fingerprint)) {
+                return files.keep(element);
+            }
+
+            GeneratedFiles::ElementScope scope(files, element, fingerprint);
+            return scope.complete(func());
+        });
+}
+
+void addMessagesTasks(DB& db, parallel::TasksList& tasks, bool incremental)
+{
+    auto& messages = db.getMessages();
+    for (auto iter = messages.begin(); iter != messages.end(); ++iter) {
+        assert(iter->second);
+        auto* msg = iter->second.get();
+        std::uint64_t fingerprint = incremental ? db.getMessageFingerprint(*msg) : 0U;
+        addElementTask(
+            db, tasks, stats::Kind::Message, "message:" + iter->first, fingerprint, incremental,
+            [msg]()
+            {
+                return msg->write();
+            });
+    }
+}
+
+bool writeFieldBase(DB& db)
+{
+    FieldBase fieldBase(db);
+    return fieldBase.write();
+}
+
+void addTypesTasks(DB& db, parallel::TasksList& tasks, bool incremental)
+{
+    for (auto& t : db.getTypes()) {
+        assert(t.second);
+        auto* type = t.second.get();
+        // Transport framing types are updated with the details of the
+        // whole schema, always regenerate them.
+        bool canSkip = incremental && (!db.isTransportType(t.first));
+        std::uint64_t fingerprint = canSkip ? db.getTypeFingerprint(t.first) : 0U;
+        addElementTask(
+            db, tasks, stats::Kind::Type, "type:" + t.first, fingerprint, canSkip,
+            [type]()
+            {
+                return type->writeProtocolDef();
+            });
+    }
+}
+
+bool writeAllFields(DB& db)
+{
+    AllFields allFields(db);
+    return allFields.write();
+}
+
+bool writeDefaultOptions(DB& db)
+{
+    auto fileRelPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::defaultOptionsFileName());
+    log::info() << "Generating " << fileRelPath << std::endl;
+
+    auto filePath = (bf::path(db.getRootPath()) / fileRelPath).string();
+
+    OutputFile stream(db, filePath);
+    if (!stream) {
+        log::error() << "Failed to create " << filePath << std::endl;
+        return false;
+    }
+
+    auto& ns = db.getProtocolNamespace();
+    stream << "/// \\file\n"
+              "/// \\brief Contains definition of \\ref " << common::scopeFor(ns, common::defaultOptionsStr()) << " default options class.\n"
+              "\n\n"
+              "#pragma once\n\n";
+
+    bool boundedStorage = db.isBoundedGroupStorageRecorded() || db.isBoundedDataStorageRecorded();
+    if (boundedStorage) {
+        stream << "#include <cstddef>\n\n";
+    }
+
+    stream << "#include \"comms/options.h\"\n";
+
+    if (db.isLazyReadEnabled()) {
+        stream << "#include " << common::localHeader(ns, common::builtinNamespaceNameStr(), common::lazyReadFileName()) << '\n';
+    }
+
+    stream << '\n';
+
+    if (!ns.empty()) {
+        stream << "namespace " << ns << "\n"
+                  "{\n\n";
+    }
+
+    stream << "/// \\brief Default options for the protocol.\n"
+              "/// \\details Defines \\b comms::option::EmptyOption to be extra option\n"
+              "///     of every defined field. To customize the protocol options, just\n"
+              "///     inherith from this struct and redefine relevant types.\n"
+              "/// \\headerfile " << common::localHeader(ns, common::defaultOptionsFileName()) << "\n"
+              "struct " << common::defaultOptionsStr() << "\n"
+              "{\n";
+
+    if (db.isBoundedGroupStorageRecorded()) {
+        stream << output::indent(1) << "/// \\brief Storage option of the groups which \\b numInGroup is limited by \\b maxValue.\n" <<
+                  output::indent(1) << "/// \\details Keeps the elements in the fixed size storage, redefine it to be\n" <<
+                  output::indent(1) << "///     \\b comms::option::EmptyOption to use \\b std::vector instead.\n" <<
+                  output::indent(1) << "template <std::size_t TSize>\n" <<
+                  output::indent(1) << "using " << common::boundedGroupStorageStr() << " = comms::option::FixedSizeStorage<TSize>;\n\n";
+    }
+
+    if (db.isBoundedDataStorageRecorded()) {
+        stream << output::indent(1) << "/// \\brief Storage option of the data fields which length is limited by \\b maxValue.\n" <<
+                  output::indent(1) << "/// \\details Keeps the data in the fixed size storage, redefine it to be\n" <<
+                  output::indent(1) << "///     \\b comms::option::EmptyOption to use dynamic memory allocation instead.\n" <<
+                  output::indent(1) << "template <std::size_t TSize>\n" <<
+                  output::indent(1) << "using " << common::boundedDataStorageStr() << " = comms::option::FixedSizeStorage<TSize>;\n\n";
+    }
+
+    stream << output::indent(1) << "/// \\brief Scope for the options relevant to fields from\n" <<
+              output::indent(1) << "///     " << common::scopeFor(ns, common::fieldNamespaceNameStr()) << " namespace.\n" <<
+              output::indent(1) << "struct " << common::fieldNamespaceNameStr() << '\n' <<
+              output::indent(1) << "{\n";
+
+    bool result = true;
+    auto fieldsScope = common::scopeFor(ns, common::fieldNamespaceStr());
+    for (auto& t : db.getTypes()) {
+        result = t.second->writeDefaultOptions(stream, 2, fieldsScope) && result;
+    }
+
+    stream << output::indent(1) << "}; // " << common::fieldNamespaceNameStr() << "\n\n" <<
+              output::indent(1) << "/// \\brief Scope for all the options relevant to messages' fields.\n" <<
+              output::indent(1) << "struct " << common::messageNamespaceNameStr() << '\n' <<
+              output::indent(1) << "{\n";
+
+    if (db.isLazyReadEnabled()) {
+        stream << output::indent(2) << "/// \\brief Lazy read mode of the groups and data fields of all the messages.\n" <<
+                  output::indent(2) << "/// \\details Use \\ref " << common::scopeFor(ns, common::builtinNamespaceStr() + common::lazyReadStr()) << "Validated\n" <<
+                  output::indent(2) << "///     or \\ref " << common::scopeFor(ns, common::builtinNamespaceStr() + common::lazyReadStr()) << "Unchecked\n" <<
+                  output::indent(2) << "///     to postpone decoding of these fields until they are accessed.\n" <<
+                  output::indent(2) << "using " << common::lazyReadStr() << " = " << common::builtinNamespaceStr() << common::lazyReadStr() << "Disabled;\n\n";
+    }
+
+    auto messagesScope = common::scopeFor(ns, common::messageNamespaceStr());
+    for (auto& m : db.getMessages()) {
+        assert(m.second);
+        result = m.second->writeDefaultOptions(stream, 2, messagesScope) && result;
+    }
+
+    stream << output::indent(1) << "}; // " << common::messageNamespaceNameStr() << "\n\n" <<
+              "}; // DefaultOptions\n\n";
+
+    if (!ns.empty()) {
+        stream << "} // namespace " << ns << "\n\n";
+    }
+
+    if (!stream.good()) {
+        log::error() << "The file " << fileRelPath << "hasn't been written properly!" << std::endl;
+        return false;
+    }
+
+    return result && stream.commit();
+}
+
+bool writeMsgId(DB& db)
+{
+    MsgId msgId(db);
+    return msgId.write();
+}
+
+bool writeMsgInterface(DB& db)
+{
+    MsgInterface msgInterface(db);
+    return msgInterface.write();
+}
+
+bool writeAllMessages(DB& db)
+{
+    AllMessages obj(db);
+    return obj.write();
+}
+
+bool writeMsgFactory(DB& db)
+{
+    MsgFactory obj(db);
+    return obj.write();
+}
+
+bool writeMessageHeaderLayer(DB& db)
+{
+    MessageHeaderLayer obj(db);
+    return obj.write();
+}
+
+bool writeOpenFramingHeaderLayer(DB& db)
+{
+    OpenFramingHeaderLayer obj(db);
+    return obj.write();
+}
+
+bool writeTransportFrame(DB& db)
+{
+    TransportFrame obj(db);
+    return obj.write();
+}
+
+bool writeTransportMessage(DB& db)
+{
+    TransportMessage obj(db);
+    return obj.write();
+}
+
+bool writeProtocol(DB& db)
+{
+    Protocol obj(db);
+    return obj.write();
+}
+
+bool writePlugin(DB& db)
+{
+    Plugin obj(db);
+    return obj.write();
+}
+
+bool writeCmake(DB& db)
+{
+    Cmake obj(db);
+    return obj.write();
+}
+
+bool writeExplicitInstantiation(DB& db)
+{
+    if (!db.hasExplicitInstantiation()) {
+        return true;
+    }
+
+    ExplicitInstantiation obj(db);
+    return obj.write();
+}
+
+bool writeDoxygen(DB& db)
+{
+    Doxygen obj(db);
+    return obj.write();
+}
+
+void addWriteTasks(DB& db, parallel::TasksList& tasks, bool incremental)
+{
+    // The components depend on the whole schema. The fingerprints are
+    // computed only when they are used to skip the up to date elements,
+    // otherwise empty fingerprint is recorded and the next incremental
+    // run regenerates everything.
+    std::uint64_t schemaFingerprint = incremental ? db.getSchemaFingerprint() : 0U;
+    using WriteFunc = bool (*)(DB&);
+    using ComponentsList = std::initializer_list<DB::Component>;
+    auto isRequired =
+        [&db](ComponentsList comps)
+        {
+            return
+                std::any_of(
+                    comps.begin(), comps.end(),
+                    [&db](DB::Component c)
+                    {
+                        return db.isComponentEnabled(c);
+                    });
+        };
+
+    // Every writer declares the components it produces output for,
+    // the writers not required by any selected component don't run.
+    auto addTaskFunc =
+        [&db, &tasks, schemaFingerprint, incremental, &isRequired](const char* name, WriteFunc func, ComponentsList comps)
+        {
+            if (!isRequired(comps)) {
+                return;
+            }
+
+            addElementTask(
+                db, tasks, stats::Kind::Component, std::string("component:") + name, schemaFingerprint, incremental,
+                [&db, func]()
+                {
+                    return func(db);
+                });
+        };
+
+    using C = DB::Component;
+    addTaskFunc("MessageSchema", &writeMessageSchema, {C::Protocol});
+    addTaskFunc("BuiltIn", &writeBuiltIn, {C::Protocol});
+    if (isRequired({C::Protocol, C::Plugin})) {
+        addMessagesTasks(db, tasks, incremental);
+    }
+    addTaskFunc("FieldBase", &writeFieldBase, {C::Protocol});
+    if (isRequired({C::Protocol})) {
+        addTypesTasks(db, tasks, incremental);
+    }
+    addTaskFunc("AllFields", &writeAllFields, {C::Plugin});
+    addTaskFunc("DefaultOptions", &writeDefaultOptions, {C::Protocol});
+    addTaskFunc("MsgId", &writeMsgId, {C::Protocol});
+    addTaskFunc("MsgInterface", &writeMsgInterface, {C::Protocol, C::Plugin});
+    addTaskFunc("AllMessages", &writeAllMessages, {C::Protocol, C::Plugin});
+    addTaskFunc("MsgFactory", &writeMsgFactory, {C::Protocol});
+    addTaskFunc("MessageHeaderLayer", &writeMessageHeaderLayer, {C::Protocol});
+    addTaskFunc("OpenFramingHeaderLayer", &writeOpenFramingHeaderLayer, {C::Protocol});
+    addTaskFunc("TransportFrame", &writeTransportFrame, {C::Protocol, C::Plugin});
+    addTaskFunc("ExplicitInstantiation", &writeExplicitInstantiation, {C::Protocol});
+    addTaskFunc("TransportMessage", &writeTransportMessage, {C::Plugin});
+    addTaskFunc("Protocol", &writeProtocol, {C::Plugin});
+    addTaskFunc("Plugin", &writePlugin, {C::Plugin});
+    addTaskFunc("Cmake", &writeCmake, {C::Cmake});
+    addTaskFunc("Doxygen", &writeDoxygen, {C::Doc});
+}
+
+} // namespace
+
+Generator::Generator(const ProgramOptions& options, OutputSink& sink)
+  : m_options(options),
+    m_sink(sink)
+{
+}
+
+Generator::~Generator() noexcept = default;
+
+void Generator::addFile(const std::string& path)
+{
+    Input input;
+    input.m_name = path;
+    m_inputs.push_back(std::move(input));
+}
+
+void Generator::addBuffer(const std::string& name, std::string contents)
+{
+    Input input;
+    input.m_name = name;
+    input.m_contents = std::move(contents);
+    input.m_inMemory = true;
+    m_inputs.push_back(std::move(input));
+}
+
+void Generator::addInclude(const std::string& path, std::string contents)
+{
+    m_includes.emplace_back(path, std::move(contents));
+}
+
+bool Generator::generate()
+{
+    DbsList dbs;
+    bool result = false;
+    {
+        stats::Scope scope(stats::Kind::Phase, "parse");
+        result = parseAll(dbs) && assignRootPaths(dbs);
+    }
+
+    if (!result) {
+        return false;
+    }
+
+    stats::Scope scope(stats::Kind::Phase, "generate");
+    result = writeAll(dbs);
+    m_prevDbs = std::move(dbs);
+    return result;
+}
+
+bool Generator::parseAll(DbsList& dbs)
+{
+    if (m_inputs.empty()) {
+        log::error() << "Message schema hasn't been provided." << std::endl;
+        return false;
+    }
+
+    // The cache shares the included files between the schemas, every
+    // schema gets its own copy of the document.
+    SchemaCache cache;
+    for (auto& i : m_includes) {
+        if (!cache.addFile(i.first, i.second)) {
+            return false;
+        }
+    }
+
+    parallel::TasksList tasks;
+    for (auto& i : m_inputs) {
+        dbs.emplace_back(new DB(m_sink));
+        auto* db = dbs.back().get();
+        auto* input = &i;
+        tasks.push_back(
+            [this, db, input, &cache]()
+            {
+                XmlDocPtr doc;
+                {
+                    stats::Scope scope(stats::Kind::Phase, "load");
+                    if (input->m_inMemory) {
+                        doc = cache.loadMemory(input->m_contents, input->m_name);
+                    }
+                    else {
+                        doc = cache.load(input->m_name);
+                    }
+                }
+
+                if (!doc) {
+                    log::error() << "Invalid schema file: \"" << input->m_name << "\"!" << std::endl;
+                    return false;
+                }
+
+                return db->parseSchema(m_options, std::move(doc));
+            });
+    }
+
+    bool result = parallel::run(tasks, m_options.getJobsCount());
+    m_includedFiles = cache.getIncludedFiles();
+    return result;
+}
+
+bool Generator::assignRootPaths(DbsList& dbs)
+{
+    std::set<std::string> paths;
+    for (auto& db : dbs) {
+        assert(db);
+        std::string rootPath;
+        if (1U < dbs.size()) {
+            rootPath = db->getProtocolNamespace();
+        }
+
+        if (!paths.insert(rootPath).second) {
+            log::error() << "Multiple schemas are generated into " << m_sink.location(rootPath) <<
+                            ", the protocol namespaces must be different." << std::endl;
+            return false;
+        }
+
+        db->setRootPath(rootPath);
+        log::info() << "Generating files in " << m_sink.location(rootPath) << std::endl;
+    }
+    return true;
+}
+
+bool Generator::writeAll(DbsList& dbs)
+{
+    for (auto& db : dbs) {
+        auto iter =
+            std::find_if(
+                m_prevDbs.begin(), m_prevDbs.end(),
+                [&db](const DbPtr& prev)
+                {
+                    return prev->getRootPath() == db->getRootPath();
+                });
+
+        if (iter != m_prevDbs.end()) {
+            db->getGeneratedFiles().resume((*iter)->getGeneratedFiles());
+        }
+    }
+
+    bool incremental = m_options.incrementalRequested() || m_options.watchRequested();
+    parallel::TasksList tasks;
+    for (auto& db : dbs) {
+        assert(db);
+        addWriteTasks(*db, tasks, incremental);
+    }
+
+    bool result = false;
+    {
+        stats::Scope statsScope(stats::Kind::Phase, "write");
+        result = parallel::run(tasks, m_options.getJobsCount());
+    }
+
+    stats::Scope statsScope(stats::Kind::Phase, "finalize");
+    bool finalized = true;
+    for (auto& db : dbs) {
+        finalized = db->getGeneratedFiles().finalize(result) && finalized;
+    }
+    return result && finalized;
+}
+
+} // namespace sbe2comms
@@ -0,0 +1,97 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ProgramOptions.h"
+#include "OutputSink.h"
+
+namespace sbe2comms
+{
+
+class DB;
+
+/// \brief Generates the protocol definition out of one or multiple schemas.
+/// \details The schemas can be read from the files or provided in memory.
+///     They are parsed and generated concurrently (see the "jobs" option)
+///     into the provided output sink. When multiple schemas are provided,
+///     every protocol is generated into the directory named after its
+///     namespace. The repeated generate() invocations continue from the
+///     state of the previous one, i.e. the previously written files are
+///     not read back from the sink.
+class Generator
+{
+public:
+    using FilesList = std::vector<std::string>;
+
+    Generator(const ProgramOptions& options, OutputSink& sink);
+    ~Generator() noexcept;
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    /// \brief Add schema file to read.
+    void addFile(const std::string& path);
+
+    /// \brief Add schema provided in memory.
+    /// \param[in] name Name of the schema, used in the log and to resolve
+    ///     the relative paths of the included files.
+    /// \param[in] contents Contents of the schema.
+    void addBuffer(const std::string& name, std::string contents);
+
+    /// \brief Provide in memory contents of the file included by the schemas.
+    void addInclude(const std::string& path, std::string contents);
+
+    bool generate();
+
+    /// \brief Files included by the schemas during the last generate().
+    const FilesList& getIncludedFiles() const
+    {
+        return m_includedFiles;
+    }
+
+private:
+    struct Input
+    {
+        std::string m_name;
+        std::string m_contents;
+        bool m_inMemory = false;
+    };
+
+    using InputsList = std::vector<Input>;
+    using IncludesList = std::vector<std::pair<std::string, std::string> >;
+    using DbPtr = std::unique_ptr<DB>;
+    using DbsList = std::vector<DbPtr>;
+
+    bool parseAll(DbsList& dbs);
+    bool assignRootPaths(DbsList& dbs);
+    bool writeAll(DbsList& dbs);
+
+    const ProgramOptions& m_options;
+    OutputSink& m_sink;
+    InputsList m_inputs;
+    IncludesList m_includes;
+    DbsList m_prevDbs;
+    FilesList m_includedFiles;
+};
+
+} // namespace sbe2comms
@@ -78,6 +78,10 @@ bool GroupField::parseImpl()
     }
 
     getDb().recordGroupListUsage();
+    if (compType->getMaxNumInGroup() != 0U) {
+        getDb().recordBoundedGroupStorageUsage();
+    }
+
     recordExtraHeader(common::localHeader(getDb().getProtocolNamespace(), common::builtinNamespaceNameStr(), common::groupListStr() + ".h"));
     recordExtraHeader(common::localHeader(getDb().getProtocolNamespace(), common::fieldNamespaceNameStr(), m_type->getName() + ".h"));
     ExtraHeaders membersHeaders;
@@ -139,7 +143,15 @@ bool GroupField::writeImpl(std::ostream& out, unsigned indent, const std::string
     }
     out << output::indent(indent + 2) << ">,\n" <<
            output::indent(indent + 2) << basicFieldCount << ",\n" <<
-           output::indent(indent + 2) << getFieldOptString() << '\n' <<
+           output::indent(indent + 2) << getFieldOptString();
+
+    auto maxCount = asCompositeType(m_type)->getMaxNumInGroup();
+    if (maxCount != 0U) {
+        out << ",\n" <<
+               output::indent(indent + 2) << common::optParamPrefixStr() << "template " << common::boundedGroupStorageStr() << '<' << maxCount << '>';
+    }
+
+    out << '\n' <<
            output::indent(indent + 1) << ">;\n\n";
     return true;
 }
@@ -228,7 +240,7 @@ bool GroupField::prepareMembers()
     std::set<std::string> memNames;
 
     auto addPaddingFunc =
-        [this, &padCount, &expOffset, &scope, &lastSinceVersion, &thisFieldSinceVersion](xmlNodePtr c, unsigned padLen, bool before = true) -> bool
+        [this, &padCount, &expOffset, &scope, &lastSinceVersion, &thisFieldSinceVersion](unsigned padLen) -> bool
         {
             ++padCount;
             auto* padType = getDb().getPaddingType(padLen);
@@ -255,16 +267,7 @@ bool GroupField::prepareMembers()
             assert(castedPadMem->getSerializationLength() == padLen);
             expOffset += padLen;
             m_members.push_back(std::move(padField));
-            if (before) {
-                assert(c != nullptr);
-                xmlAddPrevSibling(c, padNode.release());
-            }
-            else if (c != nullptr) {
-                xmlAddNextSibling(c, padNode.release());
-            }
-            else {
-                xmlAddChild(getNode(), padNode.release());
-            }
+            m_paddingNodes.push_back(std::move(padNode));
             return true;
         };
 
@@ -349,7 +352,7 @@ bool GroupField::prepareMembers()
 
 
             auto padLen = offset - expOffset;
-            if (!addPaddingFunc(c, padLen)) {
+            if (!addPaddingFunc(padLen)) {
                 return false;
             }
         } while (false);
@@ -368,11 +371,7 @@ bool GroupField::prepareMembers()
     }
 
     if (rootBlock && (blockLength != 0) && (expOffset < blockLength)) {
-        xmlNodePtr c = nullptr;
-        if (!m_members.empty()) {
-            c = m_members.back()->getNode();
-        }
-        return addPaddingFunc(c, blockLength - expOffset);
+        return addPaddingFunc(blockLength - expOffset);
     }
 
     return true;
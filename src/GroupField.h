@@ -34,6 +34,16 @@ public:
     {
     }
 
+    const std::vector<FieldPtr>& getMembers() const
+    {
+        return m_members;
+    }
+
+    const Type* getReferencedDimensionType() const
+    {
+        return m_type;
+    }
+
 protected:
     virtual Kind getKindImpl() const override;
     virtual unsigned getSinceVersionImpl() const override;
@@ -56,6 +66,7 @@ private:
     const std::string& getDimensionType() const;
     bool writeMembersDefaultOptions(std::ostream& out, unsigned indent, const std::string& scope);
 
+    std::vector<XmlNodePtr> m_paddingNodes;
     std::vector<FieldPtr> m_members;
     const Type* m_type = nullptr;
 };
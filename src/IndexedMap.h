@@ -0,0 +1,147 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <functional>
+#include <utility>
+
+namespace sbe2comms
+{
+
+/// \brief Map of named elements with constant time lookup.
+/// \details Iteration follows the sorted order of the names, which keeps
+///     the generated output deterministic, while the lookups go through the
+///     hash index. Every name is stored only once, the index refers to the
+///     key kept by the sorted storage.
+template <typename TValue>
+class IndexedMap
+{
+    using Storage = std::map<std::string, TValue>;
+
+public:
+    using key_type = std::string;
+    using mapped_type = TValue;
+    using value_type = typename Storage::value_type;
+    using iterator = typename Storage::iterator;
+    using const_iterator = typename Storage::const_iterator;
+
+    IndexedMap() = default;
+    IndexedMap(const IndexedMap&) = delete;
+    IndexedMap& operator=(const IndexedMap&) = delete;
+
+    iterator begin()
+    {
+        return m_storage.begin();
+    }
+
+    iterator end()
+    {
+        return m_storage.end();
+    }
+
+    const_iterator begin() const
+    {
+        return m_storage.begin();
+    }
+
+    const_iterator end() const
+    {
+        return m_storage.end();
+    }
+
+    std::size_t size() const
+    {
+        return m_storage.size();
+    }
+
+    bool empty() const
+    {
+        return m_storage.empty();
+    }
+
+    iterator find(const std::string& key)
+    {
+        auto iter = m_index.find(&key);
+        if (iter == m_index.end()) {
+            return m_storage.end();
+        }
+        return iter->second;
+    }
+
+    const_iterator find(const std::string& key) const
+    {
+        auto iter = m_index.find(&key);
+        if (iter == m_index.end()) {
+            return m_storage.end();
+        }
+        return iter->second;
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        auto result = m_storage.insert(std::move(value));
+        if (result.second) {
+            m_index.insert(std::make_pair(&result.first->first, result.first));
+        }
+        return result;
+    }
+
+    iterator insert(const_iterator hint, value_type&& value)
+    {
+        auto prevSize = m_storage.size();
+        auto iter = m_storage.insert(hint, std::move(value));
+        if (prevSize < m_storage.size()) {
+            m_index.insert(std::make_pair(&iter->first, iter));
+        }
+        return iter;
+    }
+
+    iterator erase(iterator pos)
+    {
+        m_index.erase(&pos->first);
+        return m_storage.erase(pos);
+    }
+
+private:
+    struct KeyHash
+    {
+        std::size_t operator()(const std::string* key) const noexcept
+        {
+            return std::hash<std::string>()(*key);
+        }
+    };
+
+    struct KeyEqual
+    {
+        bool operator()(const std::string* key1, const std::string* key2) const noexcept
+        {
+            return *key1 == *key2;
+        }
+    };
+
+    using Index = std::unordered_map<const std::string*, iterator, KeyHash, KeyEqual>;
+
+    Storage m_storage;
+    Index m_index;
+};
+
+} // namespace sbe2comms
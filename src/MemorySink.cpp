@@ -0,0 +1,57 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MemorySink.h"
+
+namespace sbe2comms
+{
+
+MemorySink::MemorySink() = default;
+MemorySink::~MemorySink() noexcept = default;
+
+bool MemorySink::existsImpl(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_files.find(path) != m_files.end();
+}
+
+bool MemorySink::readImpl(const std::string& path, std::string& contents)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto iter = m_files.find(path);
+    if (iter == m_files.end()) {
+        return false;
+    }
+
+    contents = iter->second;
+    return true;
+}
+
+bool MemorySink::writeImpl(const std::string& path, const std::string& contents)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_files[path] = contents;
+    return true;
+}
+
+bool MemorySink::removeImpl(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_files.erase(path) != 0U;
+}
+
+} // namespace sbe2comms
@@ -18,7 +18,6 @@
 #include "Message.h"
 
 #include <iostream>
-#include <fstream>
 #include <functional>
 
 #include <boost/filesystem.hpp>
@@ -28,7 +27,10 @@
 #include "output.h"
 #include "DB.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "BasicField.h"
+#include "MessageView.h"
+#include "MessageEncoder.h"
 
 namespace bf = boost::filesystem;
 
@@ -112,13 +114,13 @@ void closeFieldsDef(std::ostream& out, const std::string& name)
 
 Message::Message(DB& db, xmlNodePtr node)
   : m_db(db),
-    m_node(node)
+    m_node(node),
+    m_props(xmlParseNodeProps(node, db.getDoc()))
 {
 }
 
 bool Message::parse()
 {
-    m_props = xmlParseNodeProps(m_node, m_db.getDoc());
     if (getName().empty()) {
         return false;
     }
@@ -136,7 +138,23 @@ bool Message::parse()
 }
 bool Message::write()
 {
-    return writeProtocolDef() && writePluginHeader() && writePluginSrc();
+    if (!writeProtocolDef()) {
+        return false;
+    }
+
+    if (m_db.isViewEnabled() && (!MessageView(m_db, *this).write())) {
+        return false;
+    }
+
+    if (m_db.isEncoderEnabled() && (!MessageEncoder(m_db, *this).write())) {
+        return false;
+    }
+
+    if (!m_db.isComponentEnabled(DB::Component::Plugin)) {
+        return true;
+    }
+
+    return writePluginHeader() && writePluginSrc();
 }
 
 
@@ -197,7 +215,7 @@ bool Message::createFields()
     std::set<std::string> fieldNames;
 
     auto addPaddingFunc =
-        [this, &padCount, &expOffset, &scope, &lastSinceVersion](xmlNodePtr c, unsigned padLen, bool before = true) -> bool
+        [this, &padCount, &expOffset, &scope, &lastSinceVersion](unsigned padLen) -> bool
         {
             ++padCount;
             auto* padType = m_db.getPaddingType(padLen);
@@ -223,16 +241,7 @@ bool Message::createFields()
             assert(castedPadMem->getSerializationLength() == padLen);
             expOffset += padLen;
             m_fields.push_back(std::move(padField));
-            if (before) {
-                assert(c != nullptr);
-                xmlAddPrevSibling(c, padNode.release());
-            }
-            else if (c != nullptr) {
-                xmlAddNextSibling(c, padNode.release());
-            }
-            else {
-                xmlAddChild(m_node, padNode.release());
-            }
+            m_paddingNodes.push_back(std::move(padNode));
             return true;
         };
 
@@ -310,7 +319,7 @@ bool Message::createFields()
             }
 
             auto padLen = offset - expOffset;
-            if (!addPaddingFunc(c, padLen)) {
+            if (!addPaddingFunc(padLen)) {
                 return false;
             }
 
@@ -326,11 +335,7 @@ bool Message::createFields()
     }
 
     if (rootBlock && (blockLength != 0) && (expOffset < blockLength)) {
-        xmlNodePtr c = nullptr;
-        if (!m_fields.empty()) {
-            c = m_fields.back()->getNode();
-        }
-        return addPaddingFunc(c, blockLength - expOffset);
+        return addPaddingFunc(blockLength - expOffset);
     }
     return true;
 }
@@ -429,7 +434,9 @@ bool Message::writeMessageClass(std::ostream& out)
     writeFieldsAccess(out);
     writeConstructors(out);
     writeReadFunc(out);
+    writeReadFieldsFunc(out);
     writeRefreshFunc(out);
+    writeLazyReadFuncs(out);
     writePrivateMembers(out);
     out << "};\n\n";
 
@@ -442,6 +449,11 @@ void Message::writeFieldsAccess(std::ostream& out) const
         return;
     }
 
+    if (isLazyReadSupported()) {
+        writeLazyFieldsAccess(out);
+        return;
+    }
+
     auto& n = getName();
     out <<
         output::indent(1) << "/// \\brief Allow access to internal fields.\n" <<
@@ -472,9 +484,53 @@ void Message::writeFieldsAccess(std::ostream& out) const
     out << '\n' << output::indent(1) << ");\n\n";
 }
 
+void Message::writeLazyFieldsAccess(std::ostream& out) const
+{
+    auto& n = getName();
+    auto fieldsScope = n + common::fieldsSuffixStr();
+    out <<
+        output::indent(1) << "/// \\brief Allow access to internal fields.\n" <<
+        output::indent(1) << "/// \\details Equivalent to \\b COMMS_MSG_FIELDS_ACCESS macro\n" <<
+        output::indent(1) << "///     related to \\b comms::MessageBase class from COMMS library,\n" <<
+        output::indent(1) << "///     but the accessors of the groups and data fields decode them\n" <<
+        output::indent(1) << "///     first if their read was postponed, see decodeLazyFields().\n" <<
+        output::indent(1) << "enum FieldIdx\n" <<
+        output::indent(1) << "{\n";
+    for (auto& f : m_fields) {
+        auto& fieldName = f->getName();
+        out << output::indent(2) << "FieldIdx_" << fieldName << ", ///< Index of \\ref " << fieldsScope << "::" << fieldName << " field.\n";
+    }
+    out << output::indent(2) << "FieldIdx_numOfValues ///< Number of fields.\n" <<
+           output::indent(1) << "};\n\n" <<
+           output::indent(1) << "static_assert(std::tuple_size<typename Base::AllFields>::value == FieldIdx_numOfValues,\n" <<
+           output::indent(2) << "\"Number of fields doesn't match the FieldIdx enum\");\n\n";
+
+    for (auto& f : m_fields) {
+        auto& fieldName = f->getName();
+        auto idx = "FieldIdx_" + fieldName;
+        auto type = "typename std::tuple_element<" + idx + ", typename Base::AllFields>::type";
+        auto writeAccessorFunc =
+            [&out, &f, &idx](const std::string& sig)
+            {
+                out << output::indent(1) << sig << '\n' <<
+                       output::indent(1) << "{\n";
+                if (f->getKind() != Field::Kind::Basic) {
+                    out << output::indent(2) << "decodeLazyFields();\n";
+                }
+                out << output::indent(2) << "return std::get<" << idx << ">(Base::fields());\n" <<
+                       output::indent(1) << "}\n\n";
+            };
+
+        out << output::indent(1) << "/// \\brief Access to \\ref " << fieldsScope << "::" << fieldName << " field.\n";
+        writeAccessorFunc(type + "& field_" + fieldName + "()");
+        out << output::indent(1) << "/// \\brief Access to \\ref " << fieldsScope << "::" << fieldName << " field (const version).\n";
+        writeAccessorFunc("const " + type + "& field_" + fieldName + "() const");
+    }
+}
+
 bool Message::writeMessageDef(const std::string& filename)
 {
-    std::ofstream stream(filename);
+    OutputFile stream(m_db, filename);
     if (!stream) {
         log::error() << "Failed to create " << filename;
         return false;
@@ -495,7 +551,7 @@ bool Message::writeMessageDef(const std::string& filename)
         log::error() << "Failed to write message file" << std::endl;
     }
 
-    return result && written;
+    return result && written && stream.commit();
 }
 
 void Message::writeConstructors(std::ostream& out)
@@ -563,17 +619,25 @@ void Message::writeReadFunc(std::ostream& out)
 
         out << output::indent(2) << "updateFieldsVersion();\n";
 
-        auto nonBasicFieldIter =
-            std::find_if(
-                m_fields.begin(), m_fields.end(),
-                [](FieldsList::const_reference f)
-                {
-                    return (f->getKind() != Field::Kind::Basic);
-                });
+        bool lazy = isLazyReadSupported();
+        if (lazy) {
+            out << output::indent(2) << "m_lazyBuf = nullptr;\n" <<
+                   output::indent(2) << "m_lazyStatus = comms::ErrorStatus::Success;\n";
+        }
+
+        static const std::string LazyModeStr(
+            common::builtinNamespaceStr() + common::lazyReadStr() + "ModeFor<typename TOpt::" +
+            common::messageNamespaceStr() + common::lazyReadStr() + ", TIter>()");
 
+        auto nonBasicFieldIter = findFirstNonBasicField();
         if (nonBasicFieldIter == m_fields.begin()) {
-            out << output::indent(2) << advanceStr <<
-                   output::indent(2) << "return Base::doRead(iter, len - Base::getBlockLength());\n";
+            out << output::indent(2) << advanceStr;
+            if (lazy) {
+                out << output::indent(2) << "return readNonRoot(iter, len - Base::getBlockLength(), " << LazyModeStr << ");\n";
+                break;
+            }
+
+            out << output::indent(2) << "return Base::doRead(iter, len - Base::getBlockLength());\n";
             break;
         }
 
@@ -596,13 +660,58 @@ void Message::writeReadFunc(std::ostream& out)
                output::indent(3) << "return es;\n" <<
                output::indent(2) << "}\n\n" <<
                output::indent(2) << advanceStr <<
-               output::indent(2) << "auto remLen = len - rootBlockLen;\n" <<
-               output::indent(2) << "return Base::template doReadFieldsFrom<FieldIdx_" << fieldName << ">(iter, remLen);\n";
+               output::indent(2) << "auto remLen = len - rootBlockLen;\n";
+        if (lazy) {
+            out << output::indent(2) << "return readNonRoot(iter, remLen, " << LazyModeStr << ");\n";
+            break;
+        }
+
+        out << output::indent(2) << "return Base::template doReadFieldsFrom<FieldIdx_" << fieldName << ">(iter, remLen);\n";
 
     } while (false);
     out << output::indent(1) << "}\n\n";
 }
 
+void Message::writeReadFieldsFunc(std::ostream& out)
+{
+    auto nonBasicFieldIter = findFirstNonBasicField();
+    if (nonBasicFieldIter == m_fields.begin()) {
+        return;
+    }
+
+    std::string limitStr("FieldIdx_numOfValues");
+    if (nonBasicFieldIter != m_fields.end()) {
+        limitStr = "FieldIdx_" + (*nonBasicFieldIter)->getName();
+    }
+
+    out << output::indent(1) << "/// \\brief Read only the selected root block fields.\n" <<
+           output::indent(1) << "/// \\details Every selected field is decoded at its offset within the root block,\n" <<
+           output::indent(1) << "///     the other fields retain their values. The \\b iter is advanced\n" <<
+           output::indent(1) << "///     past the root block, so the groups and data fields that follow\n" <<
+           output::indent(1) << "///     may be read one by one using their own \\b read() or \\b readFields().\n" <<
+           output::indent(1) << "/// \\tparam TIdx Indices of the selected fields from \\ref FieldIdx.\n" <<
+           output::indent(1) << "template <std::size_t... TIdx, typename TIter>\n" <<
+           output::indent(1) << "comms::ErrorStatus readFields(TIter& iter, std::size_t len)\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "static_assert(" << common::builtinNamespaceStr() << "rootIndicesValid<" << limitStr << ", TIdx...>(),\n" <<
+           output::indent(3) << "\"Only root block fields can be selected\");\n" <<
+           output::indent(2) << "if (len < Base::getBlockLength()) {\n" <<
+           output::indent(3) << "return comms::ErrorStatus::NotEnoughData;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "updateFieldsVersion();\n";
+    if (isLazyReadSupported()) {
+        out << output::indent(2) << "m_lazyBuf = nullptr;\n" <<
+               output::indent(2) << "m_lazyStatus = comms::ErrorStatus::Success;\n";
+    }
+    out << output::indent(2) << "auto es = " << common::builtinNamespaceStr() << "readRootFields<TIdx...>(Base::fields(), iter, Base::getBlockLength());\n" <<
+           output::indent(2) << "if (es != comms::ErrorStatus::Success) {\n" <<
+           output::indent(3) << "return es;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "std::advance(iter, Base::getBlockLength());\n" <<
+           output::indent(2) << "return comms::ErrorStatus::Success;\n" <<
+           output::indent(1) << "}\n\n";
+}
+
 void Message::writeRefreshFunc(std::ostream& out)
 {
     if (m_fields.empty()) {
@@ -611,8 +720,13 @@ void Message::writeRefreshFunc(std::ostream& out)
 
     out << output::indent(1) << "/// \\brief Custom refresh functionality.\n" <<
            output::indent(1) << "bool doRefresh()\n" <<
-           output::indent(1) << "{\n" <<
-           output::indent(2) << "bool updated = updateFieldsVersion();\n";
+           output::indent(1) << "{\n";
+
+    if (isLazyReadSupported()) {
+        out << output::indent(2) << "decodeLazyFields();\n";
+    }
+
+    out << output::indent(2) << "bool updated = updateFieldsVersion();\n";
 
     auto nonBasicFieldIter =
         std::find_if(
@@ -645,14 +759,97 @@ void Message::writeRefreshFunc(std::ostream& out)
            output::indent(1) << "}\n\n";
 }
 
+void Message::writeLazyReadFuncs(std::ostream& out)
+{
+    if (!isLazyReadSupported()) {
+        return;
+    }
+
+    auto& name = getReferenceName();
+    auto& fieldName = (*findFirstNonBasicField())->getName();
+    out << output::indent(1) << "/// \\brief Decode the groups and data fields, whose read was postponed.\n" <<
+           output::indent(1) << "/// \\details Invoked by the accessors of these fields as well as by write,\n" <<
+           output::indent(1) << "///     length calculation and validity check of the message. The input\n" <<
+           output::indent(1) << "///     buffer used to read the message must remain valid until then.\n" <<
+           output::indent(1) << "///     Access through \\b fields() doesn't decode the fields.\n" <<
+           output::indent(1) << "/// \\return Status of the postponed read, \\b comms::ErrorStatus::Success\n" <<
+           output::indent(1) << "///     if nothing was postponed.\n" <<
+           output::indent(1) << "comms::ErrorStatus decodeLazyFields() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "if (m_lazyBuf == nullptr) {\n" <<
+           output::indent(3) << "return m_lazyStatus;\n" <<
+           output::indent(2) << "}\n\n" <<
+           output::indent(2) << "auto* iter = m_lazyBuf;\n" <<
+           output::indent(2) << "m_lazyBuf = nullptr;\n" <<
+           output::indent(2) << "// Only the objects, which were read, have anything postponed, so they are not const.\n" <<
+           output::indent(2) << "auto& self = const_cast<" << name << "&>(*this);\n" <<
+           output::indent(2) << "m_lazyStatus = self.Base::template doReadFieldsFrom<FieldIdx_" << fieldName << ">(iter, m_lazyLen);\n" <<
+           output::indent(2) << "return m_lazyStatus;\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Custom write functionality, decodes the postponed fields first.\n" <<
+           output::indent(1) << "template <typename TIter>\n" <<
+           output::indent(1) << "comms::ErrorStatus doWrite(TIter& iter, std::size_t len) const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "decodeLazyFields();\n" <<
+           output::indent(2) << "return Base::doWrite(iter, len);\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Custom length calculation, decodes the postponed fields first.\n" <<
+           output::indent(1) << "std::size_t doLength() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "decodeLazyFields();\n" <<
+           output::indent(2) << "return Base::doLength();\n" <<
+           output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Custom validity check, fails if the postponed read fails.\n" <<
+           output::indent(1) << "bool doValid() const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "return (decodeLazyFields() == comms::ErrorStatus::Success) && Base::doValid();\n" <<
+           output::indent(1) << "}\n\n";
+}
+
 void Message::writePrivateMembers(std::ostream& out)
 {
     if (m_fields.empty()) {
         return;
     }
 
-    out << "private:\n" <<
-           output::indent(1) << "bool updateFieldsVersion()\n" <<
+    out << "private:\n";
+    if (isLazyReadSupported()) {
+        auto& fieldName = (*findFirstNonBasicField())->getName();
+        out << output::indent(1) << "template <typename TIter>\n" <<
+               output::indent(1) << "comms::ErrorStatus readNonRoot(TIter& iter, std::size_t len, " << common::builtinNamespaceStr() << common::lazyReadStr() << "Disabled)\n" <<
+               output::indent(1) << "{\n" <<
+               output::indent(2) << "return Base::template doReadFieldsFrom<FieldIdx_" << fieldName << ">(iter, len);\n" <<
+               output::indent(1) << "}\n\n" <<
+               output::indent(1) << "template <typename TIter>\n" <<
+               output::indent(1) << "comms::ErrorStatus readNonRoot(TIter& iter, std::size_t len, " << common::builtinNamespaceStr() << common::lazyReadStr() << "Validated)\n" <<
+               output::indent(1) << "{\n" <<
+               output::indent(2) << "const std::uint8_t* buf = iter;\n" <<
+               output::indent(2) << "auto blockLength = Base::getBlockLength();\n" <<
+               output::indent(2) << getName() << common::viewStr() << " view;\n" <<
+               output::indent(2) << "if (!view.wrap(buf - blockLength, blockLength + len, blockLength, Base::getVersion())) {\n" <<
+               output::indent(3) << "return comms::ErrorStatus::NotEnoughData;\n" <<
+               output::indent(2) << "}\n\n" <<
+               output::indent(2) << "return readLazy(iter, view.length() - blockLength);\n" <<
+               output::indent(1) << "}\n\n" <<
+               output::indent(1) << "template <typename TIter>\n" <<
+               output::indent(1) << "comms::ErrorStatus readNonRoot(TIter& iter, std::size_t len, " << common::builtinNamespaceStr() << common::lazyReadStr() << "Unchecked)\n" <<
+               output::indent(1) << "{\n" <<
+               output::indent(2) << "return readLazy(iter, len);\n" <<
+               output::indent(1) << "}\n\n" <<
+               output::indent(1) << "template <typename TIter>\n" <<
+               output::indent(1) << "comms::ErrorStatus readLazy(TIter& iter, std::size_t len)\n" <<
+               output::indent(1) << "{\n" <<
+               output::indent(2) << "m_lazyBuf = iter;\n" <<
+               output::indent(2) << "m_lazyLen = len;\n" <<
+               output::indent(2) << "std::advance(iter, len);\n" <<
+               output::indent(2) << "return comms::ErrorStatus::Success;\n" <<
+               output::indent(1) << "}\n\n" <<
+               output::indent(1) << "mutable const std::uint8_t* m_lazyBuf = nullptr;\n" <<
+               output::indent(1) << "mutable std::size_t m_lazyLen = 0U;\n" <<
+               output::indent(1) << "mutable comms::ErrorStatus m_lazyStatus = comms::ErrorStatus::Success;\n\n";
+    }
+
+    out << output::indent(1) << "bool updateFieldsVersion()\n" <<
            output::indent(1) << "{\n" <<
            output::indent(2) << "return comms::util::tupleAccumulate(Base::fields(), false, " <<
                                 common::builtinNamespaceStr() << common::versionSetterStr() << "(Base::getVersion()));\n" <<
@@ -677,15 +874,23 @@ void Message::writeExtraDefHeaders(std::ostream& out)
         extraHeaders.insert("\"comms/util/Tuple.h\"");
     }
 
+    if (findFirstNonBasicField() != m_fields.begin()) {
+        extraHeaders.insert(common::localHeader(m_db.getProtocolNamespace(), common::builtinNamespaceNameStr(), common::projectionFileName()));
+    }
+
+    if (isLazyReadSupported()) {
+        auto& ns = m_db.getProtocolNamespace();
+        extraHeaders.insert("<cstdint>");
+        extraHeaders.insert("<tuple>");
+        extraHeaders.insert(common::localHeader(ns, common::builtinNamespaceNameStr(), common::lazyReadFileName()));
+        extraHeaders.insert(common::localHeader(ns, common::messageNamespaceNameStr(), getName() + common::viewFileName()));
+    }
+
     common::writeExtraHeaders(out, extraHeaders);
 }
 
 bool Message::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace(), common::messageDirName())) {
-        return false;
-    }
-
     auto messageDirRelPath =
             common::protocolDirRelPath(m_db.getProtocolNamespace(), common::messageDirName());
 
@@ -700,15 +905,11 @@ bool Message::writeProtocolDef()
 
 bool Message::writePluginHeader()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath(), common::messageDirName())) {
-        return false;
-    }
-
     auto& ns = common::pluginNamespaceNameStr();
     auto relPath = common::pathTo(ns, common::messageDirName() + '/' + getName() + ".h");
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -735,21 +936,17 @@ bool Message::writePluginHeader()
            output::indent(1) << "virtual const QVariantList& fieldsPropertiesImpl() const override;\n" <<
            "};\n\n";
     closePluginNamespaces(out, m_db);
-    return true;
+    return out.commit();
 
 }
 
 bool Message::writePluginSrc()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath(), common::messageDirName())) {
-        return false;
-    }
-
     auto& ns = common::pluginNamespaceNameStr();
     auto relPath = common::pathTo(ns, common::messageDirName() + '/' + getName() + ".cpp");
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -762,7 +959,12 @@ bool Message::writePluginSrc()
 
     openPluginNamespaces(out, m_db);
 
+    // The helper functions are scoped by the message name to allow
+    // unity build of multiple messages in a single translation unit.
+    auto detailsNs = getName() + "Props";
     out << "namespace\n"
+           "{\n\n"
+           "namespace " << detailsNs << "\n"
            "{\n\n";
 
     static const std::string createFieldPropsFuncPrefix("createFieldProps_");
@@ -793,6 +995,7 @@ bool Message::writePluginSrc()
 
     out << output::indent(1) << "return props;\n"
            "}\n\n"
+           "} // namespace " << detailsNs << "\n\n"
            "} // namespace\n\n"
            "const char* " << getReferenceName() << "::nameImpl() const\n"
            "{\n" <<
@@ -801,15 +1004,31 @@ bool Message::writePluginSrc()
            "}\n\n"
            "const QVariantList& " << getReferenceName() << "::fieldsPropertiesImpl() const\n"
            "{\n" <<
-           output::indent(1) << "static const auto Props = " << createPropertiesFuncName << "();\n" <<
+           output::indent(1) << "static const auto Props = " << detailsNs << "::" << createPropertiesFuncName << "();\n" <<
            output::indent(1) << "return Props;\n"
            "}\n\n";
 
     closePluginNamespaces(out, m_db);
-    return true;
+    return out.commit();
 
 }
 
 
 
+bool Message::isLazyReadSupported() const
+{
+    return m_db.isLazyReadEnabled() && (findFirstNonBasicField() != m_fields.end());
+}
+
+Message::FieldsList::const_iterator Message::findFirstNonBasicField() const
+{
+    return
+        std::find_if(
+            m_fields.begin(), m_fields.end(),
+            [](FieldsList::const_reference f)
+            {
+                return (f->getKind() != Field::Kind::Basic);
+            });
+}
+
 } // namespace sbe2comms
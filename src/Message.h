@@ -39,6 +39,16 @@ public:
     Message(const Message&) = default;
     Message(Message&&) = default;
 
+    xmlNodePtr getNode() const
+    {
+        return m_node;
+    }
+
+    const XmlPropsMap& getProps() const
+    {
+        return m_props;
+    }
+
     bool parse();
 
     bool write();
@@ -48,6 +58,11 @@ public:
     unsigned getId() const;
     bool hasFields() const;
 
+    const FieldsList& getFields() const
+    {
+        return m_fields;
+    }
+
 private:
 
     bool createFields();
@@ -55,19 +70,25 @@ private:
     bool writeAllFieldsDef(std::ostream& out);
     bool writeMessageClass(std::ostream& out);
     void writeFieldsAccess(std::ostream& out) const;
+    void writeLazyFieldsAccess(std::ostream& out) const;
     bool writeMessageDef(const std::string& filename);
     void writeConstructors(std::ostream& out);
     void writeReadFunc(std::ostream& out);
+    void writeReadFieldsFunc(std::ostream& out);
     void writeRefreshFunc(std::ostream& out);
+    void writeLazyReadFuncs(std::ostream& out);
     void writePrivateMembers(std::ostream& out);
     void writeExtraDefHeaders(std::ostream& out);
     bool writeProtocolDef();
     bool writePluginHeader();
     bool writePluginSrc();
+    bool isLazyReadSupported() const;
+    FieldsList::const_iterator findFirstNonBasicField() const;
 
     DB& m_db;
     xmlNodePtr m_node = nullptr;
     XmlPropsMap m_props;
+    std::vector<XmlNodePtr> m_paddingNodes;
     FieldsList m_fields;
 };
 
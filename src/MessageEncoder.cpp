@@ -0,0 +1,449 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MessageEncoder.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <cassert>
+
+#include <boost/filesystem.hpp>
+
+#include "DB.h"
+#include "Message.h"
+#include "BasicField.h"
+#include "GroupField.h"
+#include "CompositeType.h"
+#include "common.h"
+#include "log.h"
+#include "output.h"
+#include "OutputFile.h"
+#include "flyweight.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+using FieldsList = flyweight::FieldsList;
+using flyweight::Headers;
+using flyweight::accessorName;
+using flyweight::elementName;
+using flyweight::offsetStr;
+
+struct Context
+{
+    const DB& m_db;
+    Headers& m_headers;
+    const std::string& m_className;
+};
+
+void writeValueSetter(std::ostream& out, unsigned indent, const flyweight::Leaf& leaf)
+{
+    auto writeExprFunc =
+        [&leaf](const std::string& offStr) -> std::string
+        {
+            std::string val = "val";
+            if (leaf.m_valueType != leaf.m_rawType) {
+                val = "static_cast<" + leaf.m_rawType + ">(" + val + ')';
+            }
+            return "write<" + leaf.m_rawType + ">(" + offStr + ", " + val + ')';
+        };
+
+    auto& name = leaf.m_name;
+    auto accName = accessorName(name);
+    if (leaf.m_count == 1U) {
+        out << output::indent(indent) << "/// \\brief Set value of the \\b " << name << " field.\n" <<
+               output::indent(indent) << "void " << accName << '(' << leaf.m_valueType << " val)\n" <<
+               output::indent(indent) << "{\n" <<
+               output::indent(indent + 1) << writeExprFunc(offsetStr(leaf.m_offset)) << ";\n" <<
+               output::indent(indent) << "}\n\n";
+        return;
+    }
+
+    out << output::indent(indent) << "/// \\brief Number of elements in the \\b " << name << " field.\n" <<
+           output::indent(indent) << "static constexpr std::size_t " << accName << "Count()\n" <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent + 1) << "return " << leaf.m_count << "U;\n" <<
+           output::indent(indent) << "}\n\n" <<
+           output::indent(indent) << "/// \\brief Set element of the \\b " << name << " field, out of range index is ignored.\n" <<
+           output::indent(indent) << "void " << accName << "(std::size_t idx, " << leaf.m_valueType << " val)\n" <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent + 1) << "if (" << accName << "Count() <= idx) {\n" <<
+           output::indent(indent + 2) << "return;\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << writeExprFunc(offsetStr(leaf.m_offset) + " + (idx * " + offsetStr(leaf.m_elemLen) + ")") << ";\n" <<
+           output::indent(indent) << "}\n\n";
+
+    if (leaf.m_valueType != common::charType()) {
+        return;
+    }
+
+    out << output::indent(indent) << "/// \\brief Copy characters into the \\b " << name << " field.\n" <<
+           output::indent(indent) << "/// \\details The string is truncated to the field length, the rest\n" <<
+           output::indent(indent) << "///     of the field is filled with zeroes.\n" <<
+           output::indent(indent) << "void " << accName << "Data(const char* str, std::size_t len)\n" <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent + 1) << "if (m_buf != nullptr) {\n" <<
+           output::indent(indent + 2) << common::builtinNamespaceStr() << "encoderWriteChars(m_buf + " <<
+                                         offsetStr(leaf.m_offset) << ", " << accName << "Count(), str, len);\n" <<
+           output::indent(indent + 1) << "}\n" <<
+           output::indent(indent) << "}\n\n";
+}
+
+void writeRootSetters(
+    Context& ctx,
+    std::ostream& out,
+    unsigned indent,
+    const FieldsList& fields)
+{
+    unsigned offset = 0U;
+    for (auto& f : fields) {
+        if (f->getKind() != Field::Kind::Basic) {
+            break;
+        }
+
+        auto& basicField = static_cast<const BasicField&>(*f);
+        auto len = flyweight::wireLength(basicField);
+        auto fieldOffset = offset;
+        offset += len;
+        if (basicField.isGeneratedPadding() || (len == 0U)) {
+            continue;
+        }
+
+        auto* type = basicField.getReferencedType();
+        assert(type != nullptr);
+        // Unsupported leaves are reported and skipped, they remain zero initialised
+        flyweight::forEachLeaf(
+            ctx.m_db, ctx.m_headers, ctx.m_className, f->getName(), *type, fieldOffset,
+            [&out, indent](const flyweight::Leaf& leaf)
+            {
+                writeValueSetter(out, indent, leaf);
+            });
+    }
+}
+
+void writeNonBasicAppenders(
+    std::ostream& out,
+    unsigned indent,
+    const FieldsList& fields,
+    const std::string& cursor)
+{
+    for (auto& f : fields) {
+        if (f->getKind() == Field::Kind::Basic) {
+            continue;
+        }
+
+        auto& name = f->getName();
+        if (f->getKind() == Field::Kind::Group) {
+            auto builderType = common::builtinNamespaceStr() + "GroupBuilder<" + elementName(*f) + '>';
+            out << output::indent(indent) << "/// \\brief Start appending the \\b " << name << " group.\n" <<
+                   output::indent(indent) << "/// \\details Expected to be called after all the preceding groups\n" <<
+                   output::indent(indent) << "///     and data fields have been appended.\n" <<
+                   output::indent(indent) << builderType << ' ' << accessorName(name) << "()\n" <<
+                   output::indent(indent) << "{\n" <<
+                   output::indent(indent + 1) << "return " << builderType << '(' << cursor << ");\n" <<
+                   output::indent(indent) << "}\n\n";
+            continue;
+        }
+
+        out << output::indent(indent) << "/// \\brief Append the \\b " << name << " data field.\n" <<
+               output::indent(indent) << "/// \\details Expected to be called after all the preceding groups\n" <<
+               output::indent(indent) << "///     and data fields have been appended.\n" <<
+               output::indent(indent) << "/// \\return \\b false if the data exceeds its maximal length or doesn't fit into the buffer.\n" <<
+               output::indent(indent) << "bool " << accessorName(name) << "(const void* data, std::size_t len)\n" <<
+               output::indent(indent) << "{\n" <<
+               output::indent(indent + 1) << "return " << common::builtinNamespaceStr() << "encoderAppendData<" <<
+                                             flyweight::dataLengthType(*f) << ", Endian>(" << cursor << ", data, len, " <<
+                                             flyweight::dataMaxLength(*f) << ");\n" <<
+               output::indent(indent) << "}\n\n";
+    }
+}
+
+void writeWriteFunc(std::ostream& out, unsigned indent)
+{
+    out << output::indent(indent) << "template <typename T>\n" <<
+           output::indent(indent) << "void write(std::size_t offset, T val)\n" <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent + 1) << "if (m_buf != nullptr) {\n" <<
+           output::indent(indent + 2) << common::builtinNamespaceStr() << "encoderWrite<T, Endian>(m_buf + offset, val);\n" <<
+           output::indent(indent + 1) << "}\n" <<
+           output::indent(indent) << "}\n\n";
+}
+
+std::string encoderWriteStr(const std::string& type, const std::string& buf, unsigned offset, const std::string& val)
+{
+    return
+        common::builtinNamespaceStr() + "encoderWrite<" + type + ", Endian>(" +
+        buf + " + " + offsetStr(offset) + ", static_cast<" + type + ">(" + val + "))";
+}
+
+void writeElements(Context& ctx, std::ostream& out, unsigned indent, const FieldsList& fields);
+
+void writeElement(Context& ctx, std::ostream& out, unsigned indent, const GroupField& group)
+{
+    auto& members = group.getMembers();
+    auto name = elementName(group);
+    auto dim = flyweight::dimensionOf(group);
+
+    out << output::indent(indent) << "/// \\brief Encoder of the single element of the \\b " << group.getName() << " group.\n" <<
+           output::indent(indent) << "class " << name << '\n' <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent) << "public:\n";
+
+    writeElements(ctx, out, indent + 1, members);
+
+    out << output::indent(indent + 1) << "/// \\brief Constructor.\n" <<
+           output::indent(indent + 1) << "/// \\param[in] cursor Cursor of the containing message encoder.\n" <<
+           output::indent(indent + 1) << "/// \\param[in] buf Block of the element, \\b nullptr if it didn't fit into the buffer.\n" <<
+           output::indent(indent + 1) << name << "(" << common::builtinNamespaceStr() << "EncoderCursor& cursor, std::uint8_t* buf)\n" <<
+           output::indent(indent + 1) << "  : m_cursor(&cursor),\n" <<
+           output::indent(indent + 1) << "    m_buf(buf)\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Length of the dimension type preceding the elements.\n" <<
+           output::indent(indent + 1) << "static constexpr std::size_t dimensionLength()\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << offsetStr(dim.m_length) << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Block length of the element defined by the schema.\n" <<
+           output::indent(indent + 1) << "static constexpr std::size_t schemaBlockLength()\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << offsetStr(flyweight::rootLength(members)) << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Maximal number of elements allowed by the dimension type.\n" <<
+           output::indent(indent + 1) << "static constexpr std::size_t maxNumInGroup()\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << dim.m_maxNumInGroup << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Write the dimension type preceding the elements.\n" <<
+           output::indent(indent + 1) << "static void writeDimension(std::uint8_t* dim, std::size_t count)\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << encoderWriteStr(dim.m_blockLengthType, "dim", dim.m_blockLengthOffset, "schemaBlockLength()") << ";\n" <<
+           output::indent(indent + 2) << encoderWriteStr(dim.m_numInGroupType, "dim", dim.m_numInGroupOffset, "count") << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Check the element and everything appended so far fitted into the buffer.\n" <<
+           output::indent(indent + 1) << "bool valid() const\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return (m_buf != nullptr) && m_cursor->valid();\n" <<
+           output::indent(indent + 1) << "}\n\n";
+
+    writeRootSetters(ctx, out, indent + 1, members);
+    writeNonBasicAppenders(out, indent + 1, members, "*m_cursor");
+
+    out << output::indent(indent) << "private:\n";
+    writeWriteFunc(out, indent + 1);
+    out << output::indent(indent + 1) << common::builtinNamespaceStr() << "EncoderCursor* m_cursor = nullptr;\n" <<
+           output::indent(indent + 1) << "std::uint8_t* m_buf = nullptr;\n" <<
+           output::indent(indent) << "};\n\n";
+}
+
+void writeElements(Context& ctx, std::ostream& out, unsigned indent, const FieldsList& fields)
+{
+    for (auto& f : fields) {
+        if (f->getKind() == Field::Kind::Group) {
+            writeElement(ctx, out, indent, static_cast<const GroupField&>(*f));
+        }
+    }
+}
+
+} // namespace
+
+bool MessageEncoder::write()
+{
+    return writeProtocolDef();
+}
+
+bool MessageEncoder::writeProtocolDef()
+{
+    auto& ns = m_db.getProtocolNamespace();
+    auto* headerType = m_db.findType(m_db.getMessageHeaderType());
+    if ((headerType == nullptr) || (headerType->getKind() != Type::Kind::Composite)) {
+        log::error() << "Unknown message header type \"" << m_db.getMessageHeaderType() << "\"." << std::endl;
+        return false;
+    }
+
+    auto& msgName = m_msg.getName();
+    auto encoderName = msgName + common::encoderStr();
+    auto msgIdType = common::scopeFor(ns, common::msgIdEnumName());
+    auto& fields = m_msg.getFields();
+    auto blockLength = flyweight::rootLength(fields);
+
+    std::map<std::string, std::string> headerValues = {
+        {common::blockLengthStr(), "schemaBlockLength()"},
+        {common::templateIdStr(), "doGetId()"},
+        {common::schemaIdStr(), offsetStr(m_db.getSchemaId())},
+        {common::versionStr(), offsetStr(m_db.getSchemaVersion())}
+    };
+
+    std::vector<std::string> headerWrites;
+    Headers headerTypeHeaders;
+    unsigned headerOffset = 0U;
+    for (auto& m : asCompositeType(*headerType).getMembers()) {
+        auto iter = headerValues.find(m->getName());
+        if (iter == headerValues.end()) {
+            log::error() << "Unexpected member \"" << m->getName() << "\" of the message header." << std::endl;
+            return false;
+        }
+
+        bool result =
+            flyweight::forEachLeaf(
+                m_db, headerTypeHeaders, encoderName, m->getName(), *m, headerOffset,
+                [&headerWrites, &iter](const flyweight::Leaf& leaf)
+                {
+                    headerWrites.push_back(encoderWriteStr(leaf.m_rawType, "header", leaf.m_offset, iter->second));
+                });
+
+        if (!result) {
+            log::error() << "Cannot write \"" << m->getName() << "\" member of the message header in \"" << encoderName << "\"." << std::endl;
+            return false;
+        }
+
+        headerOffset += static_cast<unsigned>(m->getSerializationLength());
+    }
+
+    auto relPath = bf::path(common::protocolDirRelPath(ns, common::messageDirName())) / (encoderName + ".h");
+    auto filePath = bf::path(m_db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath.string() << std::endl;
+    OutputFile out(m_db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    Headers headers;
+    headers.insert("\"comms/traits.h\"");
+    headers.insert(common::localHeader(ns, common::msgIdFileName()));
+    headers.insert(common::localHeader(ns, common::builtinNamespaceNameStr(), common::encoderFileName()));
+    Context ctx{m_db, headers, encoderName};
+
+    std::stringstream body;
+    body << "/// \\brief Flyweight encoder of the \\ref " << msgName << " message.\n"
+            "/// \\details Writes the root block fields directly into the wrapped buffer\n"
+            "///     at their schema offsets. The groups and data fields are appended\n"
+            "///     in their schema order through the returned builders, while the\n"
+            "///     \\b blockLength and \\b numInGroup values of the message header and\n"
+            "///     the group dimensions are written automatically. The fields which\n"
+            "///     are not set remain zero initialised.\n"
+            "/// \\headerfile " << common::localHeader(ns, common::messageNamespaceNameStr(), encoderName + ".h") << "\n"
+            "class " << encoderName << "\n"
+            "{\n"
+            "public:\n" <<
+            output::indent(1) << "/// \\brief Endianness of the schema.\n" <<
+            output::indent(1) << "using Endian = " << flyweight::endianStr(m_db) << ";\n\n";
+
+    writeElements(ctx, body, 1, fields);
+
+    body << output::indent(1) << "/// \\brief Default constructor.\n" <<
+            output::indent(1) << encoderName << "() = default;\n\n" <<
+            output::indent(1) << "/// \\brief Copy is disabled, the group builders refer to the encoder.\n" <<
+            output::indent(1) << encoderName << "(const " << encoderName << "&) = delete;\n\n" <<
+            output::indent(1) << "/// \\brief Copy is disabled, the group builders refer to the encoder.\n" <<
+            output::indent(1) << encoderName << "& operator=(const " << encoderName << "&) = delete;\n\n" <<
+            output::indent(1) << "/// \\brief ID of the encoded message.\n" <<
+            output::indent(1) << "static constexpr " << msgIdType << " doGetId()\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return " << msgIdType << '_' << msgName << ";\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Root block length defined by the schema.\n" <<
+            output::indent(1) << "static constexpr std::size_t schemaBlockLength()\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return " << offsetStr(blockLength) << ";\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Length of the message header.\n" <<
+            output::indent(1) << "static constexpr std::size_t headerLength()\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return " << offsetStr(headerOffset) << ";\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Wrap the buffer for the message body.\n" <<
+            output::indent(1) << "/// \\details The root block is zero filled.\n" <<
+            output::indent(1) << "/// \\return \\b false if the root block doesn't fit into the buffer.\n" <<
+            output::indent(1) << "bool wrap(std::uint8_t* buf, std::size_t len)\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "m_cursor = " << common::builtinNamespaceStr() << "EncoderCursor(buf, len);\n" <<
+            output::indent(2) << "m_buf = m_cursor.append(schemaBlockLength());\n" <<
+            output::indent(2) << "return m_buf != nullptr;\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Wrap the buffer and write the message header preceding the body.\n" <<
+            output::indent(1) << "/// \\details The header reports the schema block length and version.\n" <<
+            output::indent(1) << "/// \\return \\b false if the header and the root block don't fit into the buffer.\n" <<
+            output::indent(1) << "bool wrapWithHeader(std::uint8_t* buf, std::size_t len)\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "m_cursor = " << common::builtinNamespaceStr() << "EncoderCursor(buf, len);\n" <<
+            output::indent(2) << "m_buf = nullptr;\n" <<
+            output::indent(2) << "auto* header = m_cursor.append(headerLength());\n" <<
+            output::indent(2) << "if (header == nullptr) {\n" <<
+            output::indent(3) << "return false;\n" <<
+            output::indent(2) << "}\n\n";
+
+    for (auto& w : headerWrites) {
+        body << output::indent(2) << w << ";\n";
+    }
+
+    body << output::indent(2) << "m_buf = m_cursor.append(schemaBlockLength());\n" <<
+            output::indent(2) << "return m_buf != nullptr;\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Check everything encoded so far fitted into the buffer.\n" <<
+            output::indent(1) << "bool valid() const\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return m_cursor.valid();\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Number of bytes encoded so far, including the message header if written.\n" <<
+            output::indent(1) << "std::size_t length() const\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return m_cursor.length();\n" <<
+            output::indent(1) << "}\n\n";
+
+    writeRootSetters(ctx, body, 1, fields);
+
+    writeNonBasicAppenders(body, 1, fields, "m_cursor");
+
+    body << "private:\n";
+    writeWriteFunc(body, 1);
+    body << output::indent(1) << common::builtinNamespaceStr() << "EncoderCursor m_cursor;\n" <<
+            output::indent(1) << "std::uint8_t* m_buf = nullptr;\n" <<
+            "};\n\n";
+
+    out << "/// \\file\n"
+           "/// \\brief Contains definition of " << common::scopeFor(ns, common::messageNamespaceStr() + encoderName) << " message encoder.\n\n"
+           "#pragma once\n\n"
+           "#include <cstdint>\n"
+           "#include <cstddef>\n"
+           "#include <limits>\n\n";
+    common::writeExtraHeaders(out, headers);
+    common::writeProtocolNamespaceBegin(ns, out);
+    out << "namespace " << common::messageDirName() << "\n"
+           "{\n"
+           "\n" <<
+           body.str() <<
+           "} // namespace " << common::messageDirName() << "\n"
+           "\n";
+    common::writeProtocolNamespaceEnd(ns, out);
+    out.flush();
+    bool written = out.good();
+    if (!written) {
+        log::error() << "Failed to write message encoder file" << std::endl;
+    }
+    return written && out.commit();
+}
+
+} // namespace sbe2comms
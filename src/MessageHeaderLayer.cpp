@@ -17,12 +17,12 @@
 
 #include "MessageHeaderLayer.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -38,15 +38,11 @@ bool MessageHeaderLayer::write()
 
 bool MessageHeaderLayer::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(m_db.getProtocolNamespace(), common::messageHeaderLayerFileName());
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
 
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -102,7 +98,7 @@ bool MessageHeaderLayer::writeProtocolDef()
            "/// \\brief Protocol layer that uses \\ref " << common::fieldNamespaceStr() << messageHeaderType << " field as a prefix to all the\n"
            "///        subsequent data written by other (next) layers.\n"
            "/// \\details The main purpose of this layer is to process the message header information.\n"
-           "///     Holds instance of \\b comms::MsgFactory as its private member and uses it\n"
+           "///     Holds instance of the message factory as its private member and uses it\n"
            "///     to create message with the required ID. Inherits from \\b comms::protocol::ProtocolLayerBase.\n"
            "///     Please read the documentation of the latter for details on inherited public\n"
            "///     interface. Please also read <b>Protocol Stack Tutorial</b> page from the \\b COMMS\n"
@@ -111,10 +107,14 @@ bool MessageHeaderLayer::writeProtocolDef()
            "///     a variant of \\ref Message class.\n"
            "/// \\tparam TAllMessages Types of all \\b input messages, bundled in std::tuple,\n"
            "///     that this protocol stack must be able to \\b read() as well as create (using createMsg()).\n"
+           "///     Creation of the messages out of the tuple is done by \\b comms::MsgFactory.\n"
+           "///     Alternatively it can be the \\ref " << common::msgFactoryStr() << " class, which creates all the protocol\n"
+           "///     messages and scales better with the number of messages.\n"
            "/// \\tparam TNextLayer Next transport layer type.\n"
            "/// \\tparam TField Field of message header.\n"
            "/// \\tparam TFactoryOpt All the options that will be forwarded to definition of\n"
-           "///     message factory type (comms::MsgFactory).\n"
+           "///     message factory type (comms::MsgFactory). Ignored when \\b TAllMessages\n"
+           "///     is not a tuple.\n"
            "/// \\headerfile " << common::localHeader(ns, name + ".h") << "\n"
            "template <\n" <<
            output::indent(1) << "typename TMessage,\n" <<
@@ -130,15 +130,18 @@ bool MessageHeaderLayer::writeProtocolDef()
            output::indent(2) << name << "<TMessage, TAllMessages, TNextLayer, TField, TFactoryOpt>\n" <<
            output::indent(1) << ">\n"
            "{\n" <<
-           output::indent(1) << "static_assert(comms::util::IsTuple<TAllMessages>::Value,\n" <<
-           output::indent(2) << "\"TAllMessages must be of std::tuple type\");\n\n" <<
            output::indent(1) << "using BaseImpl =\n" <<
            output::indent(2) << "comms::protocol::ProtocolLayerBase<\n" <<
            output::indent(3) << "TField,\n" <<
            output::indent(3) << "TNextLayer,\n" <<
            output::indent(3) << name << "<TMessage, TAllMessages, TNextLayer, TField, TFactoryOpt>\n" <<
            output::indent(2) << ">;\n\n" <<
-           output::indent(1) << "using Factory = comms::MsgFactory<TMessage, TAllMessages, TFactoryOpt>;\n\n" <<
+           output::indent(1) << "using Factory =\n" <<
+           output::indent(2) << "typename std::conditional<\n" <<
+           output::indent(3) << "comms::util::IsTuple<TAllMessages>::Value,\n" <<
+           output::indent(3) << "comms::MsgFactory<TMessage, TAllMessages, TFactoryOpt>,\n" <<
+           output::indent(3) << "TAllMessages\n" <<
+           output::indent(2) << ">::type;\n\n" <<
            output::indent(1) << "static_assert(TMessage::InterfaceOptions::HasMsgIdType,\n" <<
            output::indent(2) << "\"Usage of MessageHeaderLayer requires support for ID type. \"\n" <<
            output::indent(2) << "\"Use comms::option::MsgIdType option in message interface type definition.\");\n\n" <<
@@ -334,7 +337,7 @@ bool MessageHeaderLayer::writeProtocolDef()
            "};\n\n";
 
     common::writeProtocolNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
@@ -17,7 +17,6 @@
 
 #include "MessageSchema.h"
 
-#include <fstream>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
@@ -26,6 +25,7 @@
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "output.h"
 
 namespace bf = boost::filesystem;
@@ -39,9 +39,9 @@ MessageSchema::MessageSchema(xmlNodePtr node, xmlDocPtr doc)
 {
 }
 
-const std::string& MessageSchema::package()
+const std::string& MessageSchema::package() const
 {
-    return m_props["package"]; // may create missing node
+    return prop::package(m_props);
 }
 
 unsigned MessageSchema::version() const
@@ -67,14 +67,11 @@ const std::string& MessageSchema::headerType() const
 bool MessageSchema::write(DB& db)
 {
     auto& ns = db.getProtocolNamespace();
-    if (!common::createProtocolDefDir(db.getRootPath(), ns)) {
-        return false;
-    }
 
     auto relPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::messageSchemaFileNameStr());
     auto filePath = bf::path(db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -138,7 +135,7 @@ bool MessageSchema::write(DB& db)
            "};\n\n";
 
     common::writeProtocolNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
@@ -28,7 +28,7 @@ class MessageSchema
 public:
     explicit MessageSchema(xmlNodePtr node, xmlDocPtr doc);
 
-    const std::string& package();
+    const std::string& package() const;
     unsigned version() const;
     unsigned id() const;
     const std::string& byteOrder() const;
@@ -0,0 +1,666 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MessageView.h"
+
+#include <iostream>
+#include <sstream>
+#include <set>
+#include <vector>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "DB.h"
+#include "Message.h"
+#include "BasicField.h"
+#include "GroupField.h"
+#include "common.h"
+#include "log.h"
+#include "output.h"
+#include "OutputFile.h"
+#include "flyweight.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+using FieldsList = flyweight::FieldsList;
+using flyweight::Headers;
+using flyweight::accessorName;
+using flyweight::elementName;
+using flyweight::offsetStr;
+using flyweight::dataLengthType;
+
+struct Context
+{
+    const DB& m_db;
+    Headers& m_headers;
+    const std::string& m_className;
+};
+
+std::string skipExpr(
+    const Field& field,
+    const std::string& pos,
+    const std::string& end,
+    const std::string& version,
+    unsigned baseVersion)
+{
+    std::string expr;
+    if (field.getKind() == Field::Kind::Group) {
+        expr = common::builtinNamespaceStr() + "viewSkipGroup<" + elementName(field) + ">(" + pos + ", " + end + ", " + version + ")";
+    }
+    else {
+        expr = common::builtinNamespaceStr() + "viewSkipData<" + dataLengthType(field) + ", Endian>(" + pos + ", " + end + ")";
+    }
+
+    auto sinceVersion = field.getSinceVersion();
+    if (sinceVersion <= baseVersion) {
+        return expr;
+    }
+
+    return "((" + version + " < " + offsetStr(sinceVersion) + ") ? " + pos + " : " + expr + ')';
+}
+
+void writeValueAccessor(
+    std::ostream& out,
+    unsigned indent,
+    const std::string& name,
+    const std::string& valueType,
+    const std::string& readType,
+    unsigned offset,
+    unsigned count,
+    unsigned elemLen,
+    const std::string& presence)
+{
+    auto writeGuardFunc =
+        [&out, indent, &presence](const std::string& retVal)
+        {
+            if (presence.empty()) {
+                return;
+            }
+
+            out << output::indent(indent + 1) << "if (!" << presence << ") {\n" <<
+                   output::indent(indent + 2) << "return " << retVal << ";\n" <<
+                   output::indent(indent + 1) << "}\n\n";
+        };
+
+    auto readExprFunc =
+        [&valueType, &readType](const std::string& offStr) -> std::string
+        {
+            std::string expr = "read<" + readType + ">(" + offStr + ')';
+            if (valueType != readType) {
+                expr = "static_cast<" + valueType + ">(" + expr + ')';
+            }
+            return expr;
+        };
+
+    auto accName = accessorName(name);
+    if (count == 1U) {
+        out << output::indent(indent) << "/// \\brief Value of the \\b " << name << " field.\n";
+        if (!presence.empty()) {
+            out << output::indent(indent) << "/// \\details Default constructed value is returned when the field is not present.\n";
+        }
+        out << output::indent(indent) << valueType << ' ' << accName << "() const\n" <<
+               output::indent(indent) << "{\n";
+        writeGuardFunc(valueType + "()");
+        out << output::indent(indent + 1) << "return " << readExprFunc(offsetStr(offset)) << ";\n" <<
+               output::indent(indent) << "}\n\n";
+        return;
+    }
+
+    out << output::indent(indent) << "/// \\brief Number of elements in the \\b " << name << " field.\n" <<
+           output::indent(indent) << "static constexpr std::size_t " << accName << "Count()\n" <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent + 1) << "return " << count << "U;\n" <<
+           output::indent(indent) << "}\n\n" <<
+           output::indent(indent) << "/// \\brief Element of the \\b " << name << " field.\n";
+    if (!presence.empty()) {
+        out << output::indent(indent) << "/// \\details Default constructed value is returned when the field is not present.\n";
+    }
+    out << output::indent(indent) << valueType << ' ' << accName << "(std::size_t idx) const\n" <<
+           output::indent(indent) << "{\n";
+    writeGuardFunc(valueType + "()");
+    out << output::indent(indent + 1) << "return " << readExprFunc(offsetStr(offset) + " + (idx * " + offsetStr(elemLen) + ")") << ";\n" <<
+           output::indent(indent) << "}\n\n";
+
+    if (valueType != common::charType()) {
+        return;
+    }
+
+    out << output::indent(indent) << "/// \\brief Characters of the \\b " << name << " field, not necessarily null terminated.\n";
+    if (!presence.empty()) {
+        out << output::indent(indent) << "/// \\details \\b nullptr is returned when the field is not present.\n";
+    }
+    out << output::indent(indent) << "const char* " << accName << "Data() const\n" <<
+           output::indent(indent) << "{\n";
+    writeGuardFunc("nullptr");
+    out << output::indent(indent + 1) << "return reinterpret_cast<const char*>(m_buf + " << offsetStr(offset) << ");\n" <<
+           output::indent(indent) << "}\n\n";
+}
+
+struct PeekLeaf
+{
+    flyweight::Leaf m_leaf;
+    unsigned m_sinceVersion;
+    unsigned m_endOffset;
+};
+
+using PeekLeavesList = std::vector<PeekLeaf>;
+
+void writeRootAccessors(
+    Context& ctx,
+    std::ostream& out,
+    unsigned indent,
+    const FieldsList& fields,
+    unsigned baseVersion,
+    PeekLeavesList* peekLeaves = nullptr)
+{
+    unsigned offset = 0U;
+    for (auto& f : fields) {
+        if (f->getKind() != Field::Kind::Basic) {
+            break;
+        }
+
+        auto& basicField = static_cast<const BasicField&>(*f);
+        auto len = flyweight::wireLength(basicField);
+        auto fieldOffset = offset;
+        offset += len;
+        if (basicField.isGeneratedPadding() || (len == 0U)) {
+            continue;
+        }
+
+        auto& name = f->getName();
+        auto sinceVersion = f->getSinceVersion();
+        std::string presence;
+        if (baseVersion < sinceVersion) {
+            presence = "has_" + name + "()";
+            out << output::indent(indent) << "/// \\brief Check the \\b " << name << " field is present.\n" <<
+                   output::indent(indent) << "bool has_" << name << "() const\n" <<
+                   output::indent(indent) << "{\n" <<
+                   output::indent(indent + 1) << "return (" << offsetStr(sinceVersion) << " <= m_version) && (" <<
+                                                 offsetStr(offset) << " <= m_blockLength);\n" <<
+                   output::indent(indent) << "}\n\n";
+        }
+
+        auto* type = basicField.getReferencedType();
+        assert(type != nullptr);
+        auto endOffset = offset;
+        // Unsupported leaves are reported and skipped, the rest of the field is still accessible
+        flyweight::forEachLeaf(
+            ctx.m_db, ctx.m_headers, ctx.m_className, name, *type, fieldOffset,
+            [&out, indent, &presence, peekLeaves, sinceVersion, endOffset](const flyweight::Leaf& leaf)
+            {
+                writeValueAccessor(out, indent, leaf.m_name, leaf.m_valueType, leaf.m_rawType, leaf.m_offset, leaf.m_count, leaf.m_elemLen, presence);
+                if ((peekLeaves != nullptr) && (leaf.m_count == 1U)) {
+                    peekLeaves->push_back(PeekLeaf{leaf, sinceVersion, endOffset});
+                }
+            });
+    }
+}
+
+void writePeekAccessors(
+    std::ostream& out,
+    unsigned indent,
+    const PeekLeavesList& peekLeaves)
+{
+    for (auto& peekLeaf : peekLeaves) {
+        auto& leaf = peekLeaf.m_leaf;
+        auto sinceVersion = peekLeaf.m_sinceVersion;
+        auto endOffset = peekLeaf.m_endOffset;
+        auto& name = leaf.m_name;
+        out << output::indent(indent) << "/// \\brief Offset of the \\b " << name << " field within the root block.\n" <<
+               output::indent(indent) << "static constexpr std::size_t peekOffset_" << name << "()\n" <<
+               output::indent(indent) << "{\n" <<
+               output::indent(indent + 1) << "return " << offsetStr(leaf.m_offset) << ";\n" <<
+               output::indent(indent) << "}\n\n" <<
+               output::indent(indent) << "/// \\brief Check the \\b " << name << " field can be peeked.\n" <<
+               output::indent(indent) << "/// \\details The field must be present in the message of the reported\n" <<
+               output::indent(indent) << "///     \\b version and \\b blockLength as well as fit into the buffer.\n" <<
+               output::indent(indent) << "static constexpr bool canPeek_" << name << "(std::size_t len, std::size_t blockLength, unsigned";
+        if (sinceVersion != 0U) {
+            out << " version";
+        }
+        out << ")\n" <<
+               output::indent(indent) << "{\n" <<
+               output::indent(indent + 1) << "return ";
+        if (sinceVersion != 0U) {
+            out << '(' << offsetStr(sinceVersion) << " <= version) && ";
+        }
+        out << '(' << offsetStr(endOffset) << " <= blockLength) && (" << offsetStr(endOffset) << " <= len);\n" <<
+               output::indent(indent) << "}\n\n";
+
+        std::string readExpr =
+            common::builtinNamespaceStr() + "viewRead<" + leaf.m_rawType + ", Endian>(buf + " + offsetStr(leaf.m_offset) + ')';
+        if (leaf.m_valueType != leaf.m_rawType) {
+            readExpr = "static_cast<" + leaf.m_valueType + ">(" + readExpr + ')';
+        }
+
+        out << output::indent(indent) << "/// \\brief Read the \\b " << name << " field directly from the serialised body.\n" <<
+               output::indent(indent) << "/// \\details Doesn't require wrapping the message.\n" <<
+               output::indent(indent) << "/// \\param[in] buf Buffer following the message header.\n" <<
+               output::indent(indent) << "/// \\param[in] len Number of bytes in the buffer.\n" <<
+               output::indent(indent) << "/// \\param[in] blockLength Root block length reported by the message header.\n" <<
+               output::indent(indent) << "/// \\param[in] version Schema version reported by the message header.\n" <<
+               output::indent(indent) << "/// \\param[in] defValue Value to return when the field cannot be peeked.\n" <<
+               output::indent(indent) << "static " << leaf.m_valueType << " peek_" << name << "(\n" <<
+               output::indent(indent + 1) << "const std::uint8_t* buf,\n" <<
+               output::indent(indent + 1) << "std::size_t len,\n" <<
+               output::indent(indent + 1) << "std::size_t blockLength,\n" <<
+               output::indent(indent + 1) << "unsigned version,\n" <<
+               output::indent(indent + 1) << leaf.m_valueType << " defValue = " << leaf.m_valueType << "())\n" <<
+               output::indent(indent) << "{\n" <<
+               output::indent(indent + 1) << "if (!canPeek_" << name << "(len, blockLength, version)) {\n" <<
+               output::indent(indent + 2) << "return defValue;\n" <<
+               output::indent(indent + 1) << "}\n\n" <<
+               output::indent(indent + 1) << "return " << readExpr << ";\n" <<
+               output::indent(indent) << "}\n\n";
+    }
+}
+
+void writeNonBasicAccessors(
+    std::ostream& out,
+    unsigned indent,
+    const FieldsList& fields,
+    unsigned baseVersion,
+    const std::vector<std::string>& positions)
+{
+    std::size_t idx = 0U;
+    for (auto& f : fields) {
+        if (f->getKind() == Field::Kind::Basic) {
+            continue;
+        }
+
+        assert(idx < positions.size());
+        auto& pos = positions[idx];
+        ++idx;
+
+        auto& name = f->getName();
+        std::string retType;
+        std::string createExpr;
+        if (f->getKind() == Field::Kind::Group) {
+            retType = common::builtinNamespaceStr() + "GroupView<" + elementName(*f) + '>';
+            createExpr = retType + '(' + pos + ", m_version)";
+            out << output::indent(indent) << "/// \\brief Lazy view of the \\b " << name << " group.\n";
+        }
+        else {
+            retType = common::builtinNamespaceStr() + "DataView";
+            createExpr = common::builtinNamespaceStr() + "viewData<" + dataLengthType(*f) + ", Endian>(" + pos + ')';
+            out << output::indent(indent) << "/// \\brief Raw bytes of the \\b " << name << " data field.\n";
+        }
+
+        out << output::indent(indent) << retType << ' ' << accessorName(name) << "() const\n" <<
+               output::indent(indent) << "{\n";
+        auto sinceVersion = f->getSinceVersion();
+        if (baseVersion < sinceVersion) {
+            out << output::indent(indent + 1) << "if (m_version < " << offsetStr(sinceVersion) << ") {\n" <<
+                   output::indent(indent + 2) << "return " << retType << "();\n" <<
+                   output::indent(indent + 1) << "}\n\n";
+        }
+        out << output::indent(indent + 1) << "return " << createExpr << ";\n" <<
+               output::indent(indent) << "}\n\n";
+    }
+}
+
+void writeReadFunc(std::ostream& out, unsigned indent)
+{
+    out << output::indent(indent) << "template <typename T>\n" <<
+           output::indent(indent) << "T read(std::size_t offset) const\n" <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent + 1) << "return " << common::builtinNamespaceStr() << "viewRead<T, Endian>(m_buf + offset);\n" <<
+           output::indent(indent) << "}\n\n";
+}
+
+void writeElements(Context& ctx, std::ostream& out, unsigned indent, const FieldsList& fields);
+
+void writeElement(Context& ctx, std::ostream& out, unsigned indent, const GroupField& group)
+{
+    auto& members = group.getMembers();
+    auto baseVersion = group.getSinceVersion();
+    auto name = elementName(group);
+
+    auto dim = flyweight::dimensionOf(group);
+    auto readDimFunc =
+        [](const std::string& type, unsigned offset) -> std::string
+        {
+            return
+                "static_cast<std::size_t>(" + common::builtinNamespaceStr() + "viewRead<" +
+                type + ", Endian>(dim + " + offsetStr(offset) + "))";
+        };
+
+    out << output::indent(indent) << "/// \\brief View of the single element of the \\b " << group.getName() << " group.\n" <<
+           output::indent(indent) << "class " << name << '\n' <<
+           output::indent(indent) << "{\n" <<
+           output::indent(indent) << "public:\n";
+
+    writeElements(ctx, out, indent + 1, members);
+
+    out << output::indent(indent + 1) << "/// \\brief Constructor.\n" <<
+           output::indent(indent + 1) << name << "(const std::uint8_t* buf, std::size_t blockLength, unsigned version)\n" <<
+           output::indent(indent + 1) << "  : m_buf(buf),\n" <<
+           output::indent(indent + 1) << "    m_blockLength(blockLength),\n" <<
+           output::indent(indent + 1) << "    m_version(version)\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Block length of the element.\n" <<
+           output::indent(indent + 1) << "std::size_t blockLength() const\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return m_blockLength;\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Schema version of the containing message.\n" <<
+           output::indent(indent + 1) << "unsigned version() const\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return m_version;\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Length of the dimension type preceding the elements.\n" <<
+           output::indent(indent + 1) << "static constexpr std::size_t dimensionLength()\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << offsetStr(dim.m_length) << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Read \\b " << common::blockLengthStr() << " from the dimension type.\n" <<
+           output::indent(indent + 1) << "static std::size_t readBlockLength(const std::uint8_t* dim)\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << readDimFunc(dim.m_blockLengthType, dim.m_blockLengthOffset) << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Read \\b " << common::numInGroupStr() << " from the dimension type.\n" <<
+           output::indent(indent + 1) << "static std::size_t readNumInGroup(const std::uint8_t* dim)\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << readDimFunc(dim.m_numInGroupType, dim.m_numInGroupOffset) << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Minimal block length containing all the mandatory fields.\n" <<
+           output::indent(indent + 1) << "static constexpr std::size_t minBlockLength()\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << offsetStr(flyweight::minRootLength(members, baseVersion)) << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Whether the element consists of its block only.\n" <<
+           output::indent(indent + 1) << "static constexpr bool hasFixedLength()\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "return " << std::boolalpha << (!flyweight::hasNonBasic(members)) << ";\n" <<
+           output::indent(indent + 1) << "}\n\n" <<
+           output::indent(indent + 1) << "/// \\brief Get position following the element.\n" <<
+           output::indent(indent + 1) << "/// \\details Returns \\b nullptr if the element exceeds \\b end, the bounds\n" <<
+           output::indent(indent + 1) << "///     are not checked when \\b end is \\b nullptr.\n" <<
+           output::indent(indent + 1) << "static const std::uint8_t* skip(\n" <<
+           output::indent(indent + 2) << "const std::uint8_t* buf,\n" <<
+           output::indent(indent + 2) << "const std::uint8_t* end,\n" <<
+           output::indent(indent + 2) << "std::size_t blockLength,\n" <<
+           output::indent(indent + 2) << "unsigned version)\n" <<
+           output::indent(indent + 1) << "{\n" <<
+           output::indent(indent + 2) << "if ((end != nullptr) && (static_cast<std::size_t>(end - buf) < blockLength)) {\n" <<
+           output::indent(indent + 3) << "return nullptr;\n" <<
+           output::indent(indent + 2) << "}\n\n";
+
+    std::vector<const Field*> nonBasic;
+    for (auto& m : members) {
+        if (m->getKind() != Field::Kind::Basic) {
+            nonBasic.push_back(m.get());
+        }
+    }
+
+    bool versionUsed =
+        std::any_of(
+            nonBasic.begin(), nonBasic.end(),
+            [baseVersion](const Field* m)
+            {
+                return (m->getKind() == Field::Kind::Group) || (baseVersion < m->getSinceVersion());
+            });
+
+    if (!versionUsed) {
+        out << output::indent(indent + 2) << "static_cast<void>(version);\n";
+    }
+
+    if (nonBasic.empty()) {
+        out << output::indent(indent + 2) << "return buf + blockLength;\n";
+    }
+    else {
+        out << output::indent(indent + 2) << "auto* iter = buf + blockLength;\n";
+        for (auto* m : nonBasic) {
+            if (m == nonBasic.back()) {
+                out << output::indent(indent + 2) << "return " << skipExpr(*m, "iter", "end", "version", baseVersion) << ";\n";
+                break;
+            }
+
+            out << output::indent(indent + 2) << "iter = " << skipExpr(*m, "iter", "end", "version", baseVersion) << ";\n" <<
+                   output::indent(indent + 2) << "if (iter == nullptr) {\n" <<
+                   output::indent(indent + 3) << "return nullptr;\n" <<
+                   output::indent(indent + 2) << "}\n\n";
+        }
+    }
+    out << output::indent(indent + 1) << "}\n\n";
+
+    writeRootAccessors(ctx, out, indent + 1, members, baseVersion);
+
+    std::vector<std::string> positions;
+    for (auto* m : nonBasic) {
+        positions.push_back(m->getName() + "Pos()");
+    }
+    writeNonBasicAccessors(out, indent + 1, members, baseVersion, positions);
+
+    out << output::indent(indent) << "private:\n";
+    writeReadFunc(out, indent + 1);
+    for (auto idx = 0U; idx < nonBasic.size(); ++idx) {
+        out << output::indent(indent + 1) << "const std::uint8_t* " << positions[idx] << " const\n" <<
+               output::indent(indent + 1) << "{\n";
+        if (idx == 0U) {
+            out << output::indent(indent + 2) << "return m_buf + m_blockLength;\n";
+        }
+        else {
+            out << output::indent(indent + 2) << "return " << skipExpr(*nonBasic[idx - 1], positions[idx - 1], "nullptr", "m_version", baseVersion) << ";\n";
+        }
+        out << output::indent(indent + 1) << "}\n\n";
+    }
+
+    out << output::indent(indent + 1) << "const std::uint8_t* m_buf = nullptr;\n" <<
+           output::indent(indent + 1) << "std::size_t m_blockLength = 0U;\n" <<
+           output::indent(indent + 1) << "unsigned m_version = 0U;\n" <<
+           output::indent(indent) << "};\n\n";
+}
+
+void writeElements(Context& ctx, std::ostream& out, unsigned indent, const FieldsList& fields)
+{
+    for (auto& f : fields) {
+        if (f->getKind() == Field::Kind::Group) {
+            writeElement(ctx, out, indent, static_cast<const GroupField&>(*f));
+        }
+    }
+}
+
+} // namespace
+
+bool MessageView::write()
+{
+    return writeProtocolDef();
+}
+
+bool MessageView::writeProtocolDef()
+{
+    auto& ns = m_db.getProtocolNamespace();
+    auto& msgName = m_msg.getName();
+    auto viewName = msgName + common::viewStr();
+    auto relPath = bf::path(common::protocolDirRelPath(ns, common::messageDirName())) / (viewName + ".h");
+    auto filePath = bf::path(m_db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath.string() << std::endl;
+    OutputFile out(m_db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    auto& fields = m_msg.getFields();
+    Headers headers;
+    headers.insert("\"comms/traits.h\"");
+    headers.insert(common::localHeader(ns, common::msgIdFileName()));
+    headers.insert(common::localHeader(ns, common::builtinNamespaceNameStr(), common::viewFileName()));
+    Context ctx{m_db, headers, viewName};
+
+    std::vector<std::string> positions;
+    for (auto& f : fields) {
+        if (f->getKind() != Field::Kind::Basic) {
+            positions.push_back("m_pos[" + std::to_string(positions.size()) + ']');
+        }
+    }
+
+    std::stringstream body;
+    auto msgIdType = common::scopeFor(ns, common::msgIdEnumName());
+    auto blockLength = flyweight::rootLength(fields);
+    body << "/// \\brief Zero-copy view of the \\ref " << msgName << " message.\n"
+            "/// \\details Wraps the serialised message body following the message header.\n"
+            "///     The whole body is bounds-checked once by wrap(), afterwards the accessors\n"
+            "///     read the values directly from the buffer and the groups and data fields\n"
+            "///     are decoded lazily on access.\n"
+            "/// \\headerfile " << common::localHeader(ns, common::messageNamespaceNameStr(), viewName + ".h") << "\n"
+            "class " << viewName << "\n"
+            "{\n"
+            "public:\n" <<
+            output::indent(1) << "/// \\brief Endianness of the schema.\n" <<
+            output::indent(1) << "using Endian = " << flyweight::endianStr(m_db) << ";\n\n";
+
+    writeElements(ctx, body, 1, fields);
+
+    body << output::indent(1) << "/// \\brief ID of the viewed message.\n" <<
+            output::indent(1) << "static constexpr " << msgIdType << " doGetId()\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return " << msgIdType << '_' << msgName << ";\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Root block length defined by the schema.\n" <<
+            output::indent(1) << "static constexpr std::size_t schemaBlockLength()\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return " << offsetStr(blockLength) << ";\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Minimal root block length containing all the mandatory fields.\n" <<
+            output::indent(1) << "static constexpr std::size_t minBlockLength()\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return " << offsetStr(flyweight::minRootLength(fields, 0U)) << ";\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Wrap the serialised message body.\n" <<
+            output::indent(1) << "/// \\param[in] buf Buffer following the message header.\n" <<
+            output::indent(1) << "/// \\param[in] len Number of bytes in the buffer.\n" <<
+            output::indent(1) << "/// \\param[in] blockLength Root block length reported by the message header.\n" <<
+            output::indent(1) << "/// \\param[in] version Schema version reported by the message header.\n" <<
+            output::indent(1) << "/// \\return \\b true if the whole message fits into the buffer.\n" <<
+            output::indent(1) << "bool wrap(\n" <<
+            output::indent(2) << "const std::uint8_t* buf,\n" <<
+            output::indent(2) << "std::size_t len,\n" <<
+            output::indent(2) << "std::size_t blockLength = " << offsetStr(blockLength) << ",\n" <<
+            output::indent(2) << "unsigned version = " << offsetStr(m_db.getSchemaVersion()) << ")\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "if ((len < blockLength) || (blockLength < minBlockLength())) {\n" <<
+            output::indent(3) << "return false;\n" <<
+            output::indent(2) << "}\n\n" <<
+            output::indent(2) << "auto* iter = buf + blockLength;\n";
+
+    if (!positions.empty()) {
+        body << output::indent(2) << "auto* end = buf + len;\n";
+    }
+
+    std::size_t posIdx = 0U;
+    for (auto& f : fields) {
+        if (f->getKind() == Field::Kind::Basic) {
+            continue;
+        }
+
+        body << output::indent(2) << positions[posIdx] << " = iter;\n" <<
+                output::indent(2) << "iter = " << skipExpr(*f, "iter", "end", "version", 0U) << ";\n" <<
+                output::indent(2) << "if (iter == nullptr) {\n" <<
+                output::indent(3) << "return false;\n" <<
+                output::indent(2) << "}\n\n";
+        ++posIdx;
+    }
+
+    body << output::indent(2) << "m_buf = buf;\n" <<
+            output::indent(2) << "m_blockLength = blockLength;\n" <<
+            output::indent(2) << "m_length = static_cast<std::size_t>(iter - buf);\n" <<
+            output::indent(2) << "m_version = version;\n" <<
+            output::indent(2) << "return true;\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Wrap the serialised message body using the message header.\n" <<
+            output::indent(1) << "/// \\details The header is expected to be the field read by the\n" <<
+            output::indent(1) << "///     \\ref " << common::scopeFor(ns, common::messageHeaderLayerStr()) << ".\n" <<
+            output::indent(1) << "/// \\return \\b false if the header reports other message or the whole\n" <<
+            output::indent(1) << "///     message doesn't fit into the buffer.\n" <<
+            output::indent(1) << "template <typename THeader>\n" <<
+            output::indent(1) << "bool wrap(const THeader& header, const std::uint8_t* buf, std::size_t len)\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "if (static_cast<" << msgIdType << ">(header.field_templateId().value()) != doGetId()) {\n" <<
+            output::indent(3) << "return false;\n" <<
+            output::indent(2) << "}\n\n" <<
+            output::indent(2) << "return wrap(buf, len, header.field_blockLength().value(), header.field_version().value());\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Wrapped buffer.\n" <<
+            output::indent(1) << "const std::uint8_t* buffer() const\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return m_buf;\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Number of bytes occupied by the message body.\n" <<
+            output::indent(1) << "std::size_t length() const\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return m_length;\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Root block length of the wrapped message.\n" <<
+            output::indent(1) << "std::size_t blockLength() const\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return m_blockLength;\n" <<
+            output::indent(1) << "}\n\n" <<
+            output::indent(1) << "/// \\brief Schema version of the wrapped message.\n" <<
+            output::indent(1) << "unsigned version() const\n" <<
+            output::indent(1) << "{\n" <<
+            output::indent(2) << "return m_version;\n" <<
+            output::indent(1) << "}\n\n";
+
+    PeekLeavesList peekLeaves;
+    writeRootAccessors(ctx, body, 1, fields, 0U, &peekLeaves);
+    writeNonBasicAccessors(body, 1, fields, 0U, positions);
+    writePeekAccessors(body, 1, peekLeaves);
+
+    body << "private:\n";
+    writeReadFunc(body, 1);
+    body << output::indent(1) << "const std::uint8_t* m_buf = nullptr;\n" <<
+            output::indent(1) << "std::size_t m_blockLength = 0U;\n" <<
+            output::indent(1) << "std::size_t m_length = 0U;\n" <<
+            output::indent(1) << "unsigned m_version = 0U;\n";
+    if (!positions.empty()) {
+        body << output::indent(1) << "const std::uint8_t* m_pos[" << positions.size() << "] = {};\n";
+    }
+    body << "};\n\n";
+
+    out << "/// \\file\n"
+           "/// \\brief Contains definition of " << common::scopeFor(ns, common::messageNamespaceStr() + viewName) << " message view.\n\n"
+           "#pragma once\n\n"
+           "#include <cstdint>\n"
+           "#include <cstddef>\n\n";
+    common::writeExtraHeaders(out, headers);
+    common::writeProtocolNamespaceBegin(ns, out);
+    out << "namespace " << common::messageDirName() << "\n"
+           "{\n"
+           "\n" <<
+           body.str() <<
+           "} // namespace " << common::messageDirName() << "\n"
+           "\n";
+    common::writeProtocolNamespaceEnd(ns, out);
+    out.flush();
+    bool written = out.good();
+    if (!written) {
+        log::error() << "Failed to write message view file" << std::endl;
+    }
+    return written && out.commit();
+}
+
+} // namespace sbe2comms
@@ -0,0 +1,165 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "MsgFactory.h"
+
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "DB.h"
+#include "common.h"
+#include "log.h"
+#include "OutputFile.h"
+#include "output.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+// Every creation function handles consecutive range of IDs with this
+// number of messages, keeps the switch statements of manageable size.
+const std::size_t MessagesPerRange = 256U;
+
+} // namespace
+
+bool MsgFactory::write()
+{
+    return writeProtocolDef();
+}
+
+bool MsgFactory::writeProtocolDef()
+{
+    auto& ns = m_db.getProtocolNamespace();
+    auto relPath = common::protocolDirRelPath(ns, common::msgFactoryFileName());
+    auto filePath = bf::path(m_db.getRootPath()) / relPath;
+    log::info() << "Generating " << relPath << std::endl;
+    OutputFile out(m_db, filePath.string());
+    if (!out) {
+        log::error() << "Failed to create " << filePath.string() << std::endl;
+        return false;
+    }
+
+    std::vector<std::vector<std::string> > ranges;
+    for (auto& m : m_db.getMessagesById()) {
+        if (ranges.empty() || (MessagesPerRange <= ranges.back().size())) {
+            ranges.emplace_back();
+        }
+        ranges.back().push_back(m.second->first);
+    }
+
+    out << "/// \\file\n"
+           "/// \\brief Contains definition of \\ref " << common::scopeFor(ns, common::msgFactoryStr()) << " message factory.\n\n"
+           "#pragma once\n\n"
+           "#include <memory>\n\n"
+           "#include " << common::localHeader(ns, common::msgIdFileName()) << "\n"
+           "#include " << common::localHeader(ns, common::allMessagesFileName()) << "\n\n";
+
+    common::writeProtocolNamespaceBegin(ns, out);
+
+    auto idPrefix = common::msgIdEnumName() + '_';
+    out << "/// \\brief Factory of the protocol messages.\n"
+           "/// \\details Creates the message objects using \\b switch statements on the\n"
+           "///     message ID (one per range of " << MessagesPerRange << " IDs) instead of iterating over\n"
+           "///     the \\ref " << common::allMessagesStr() << " tuple the way \\b comms::MsgFactory does, so\n"
+           "///     the compilation time and memory grow linearly with the number of\n"
+           "///     messages. Can be passed to \\ref " << common::messageHeaderLayerStr() << " (as well as to\n"
+           "///     the frames defined in " << common::pathTo(ns, common::transportFrameFileName()) << ") instead of the\n"
+           "///     messages tuple.\n"
+           "/// \\tparam TMsgBase Common base (interface) class of all the messages.\n"
+           "/// \\tparam TOpt Extra options, expected to be of the same format as \\ref " << common::defaultOptionsStr() << ".\n"
+           "/// \\headerfile " << common::localHeader(ns, common::msgFactoryFileName()) << "\n"
+           "template <typename TMsgBase, typename TOpt = " << common::defaultOptionsStr() << ">\n"
+           "class " << common::msgFactoryStr() << "\n"
+           "{\n"
+           "public:\n" <<
+           output::indent(1) << "/// \\brief All the messages the factory can create bundled in std::tuple.\n" <<
+           output::indent(1) << "using " << common::allMessagesStr() << " = ::" << common::scopeFor(ns, common::allMessagesStr()) << "<TMsgBase, TOpt>;\n\n" <<
+           output::indent(1) << "/// \\brief Type of smart pointer that holds allocated message object.\n" <<
+           output::indent(1) << "using MsgPtr = std::unique_ptr<TMsgBase>;\n\n" <<
+           output::indent(1) << "/// \\brief Type of message ID when passed by the parameter.\n" <<
+           output::indent(1) << "using MsgIdParamType = typename TMsgBase::MsgIdParamType;\n\n" <<
+           output::indent(1) << "/// \\brief Create message object given its ID.\n" <<
+           output::indent(1) << "/// \\param[in] id ID of the message.\n" <<
+           output::indent(1) << "/// \\param[in] idx Relative index of the message with the same ID,\n" <<
+           output::indent(1) << "///     the message IDs are unique, so only 0 is valid.\n" <<
+           output::indent(1) << "/// \\return Smart pointer to the created message object, empty\n" <<
+           output::indent(1) << "///     one if the ID is unknown.\n" <<
+           output::indent(1) << "MsgPtr createMsg(MsgIdParamType id, unsigned idx = 0) const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "if (idx != 0U) {\n" <<
+           output::indent(3) << "return MsgPtr();\n" <<
+           output::indent(2) << "}\n\n";
+
+    if (ranges.empty()) {
+        out << output::indent(2) << "static_cast<void>(id);\n" <<
+               output::indent(2) << "return MsgPtr();\n";
+    }
+
+    for (auto idx = 0U; idx < ranges.size(); ++idx) {
+        if ((idx + 1U) == ranges.size()) {
+            out << output::indent(2) << "return createMsgRange" << idx << "(id);\n";
+            break;
+        }
+
+        out << output::indent(2) << "if (id <= " << idPrefix << ranges[idx].back() << ") {\n" <<
+               output::indent(3) << "return createMsgRange" << idx << "(id);\n" <<
+               output::indent(2) << "}\n\n";
+    }
+
+    out << output::indent(1) << "}\n\n" <<
+           output::indent(1) << "/// \\brief Create generic message, not supported.\n" <<
+           output::indent(1) << "/// \\return Always empty smart pointer.\n" <<
+           output::indent(1) << "MsgPtr createGenericMsg(MsgIdParamType id) const\n" <<
+           output::indent(1) << "{\n" <<
+           output::indent(2) << "static_cast<void>(id);\n" <<
+           output::indent(2) << "return MsgPtr();\n" <<
+           output::indent(1) << "}\n";
+
+    if (!ranges.empty()) {
+        out << "\nprivate:\n";
+    }
+
+    for (auto idx = 0U; idx < ranges.size(); ++idx) {
+        if (0U < idx) {
+            out << '\n';
+        }
+
+        out << output::indent(1) << "static MsgPtr createMsgRange" << idx << "(MsgIdParamType id)\n" <<
+               output::indent(1) << "{\n" <<
+               output::indent(2) << "switch (id) {\n";
+        for (auto& name : ranges[idx]) {
+            out << output::indent(2) << "case " << idPrefix << name << ": return MsgPtr(new " <<
+                   common::messageNamespaceStr() << name << "<TMsgBase, TOpt>());\n";
+        }
+        out << output::indent(2) << "default: break;\n" <<
+               output::indent(2) << "}\n\n" <<
+               output::indent(2) << "return MsgPtr();\n" <<
+               output::indent(1) << "}\n";
+    }
+
+    out << "};\n\n";
+    common::writeProtocolNamespaceEnd(ns, out);
+    return out.commit();
+}
+
+} // namespace sbe2comms
@@ -17,12 +17,12 @@
 
 #include "MsgId.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -38,14 +38,10 @@ bool MsgId::write()
 
 bool MsgId::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(m_db.getProtocolNamespace(), common::msgIdFileName());
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -59,9 +55,7 @@ bool MsgId::writeProtocolDef()
 
     common::writeProtocolNamespaceBegin(ns, out);
 
-    auto* msgIdNode = m_db.getMsgIdEnumNode();
-    auto props = xmlParseNodeProps(msgIdNode, m_db.getDoc());
-    auto& encType = prop::encodingType(props);
+    auto& encType = m_db.getMsgIdEncodingType();
     auto& underlyingType = common::primitiveTypeToStdInt(encType);
     assert(!underlyingType.empty());
     out << "/// \\brief Enumeration of message ID value.\n"
@@ -77,7 +71,7 @@ bool MsgId::writeProtocolDef()
     }
     out << "}; // " << common::msgIdEnumName() << "\n\n";
     common::writeProtocolNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
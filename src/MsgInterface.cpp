@@ -17,12 +17,12 @@
 
 #include "MsgInterface.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -33,20 +33,24 @@ namespace sbe2comms
 
 bool MsgInterface::write()
 {
-    return writeProtocolDef() && writePluginHeader();
+    if (!writeProtocolDef()) {
+        return false;
+    }
+
+    if (!m_db.isComponentEnabled(DB::Component::Plugin)) {
+        return true;
+    }
+
+    return writePluginHeader();
 }
 
 bool MsgInterface::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(m_db.getProtocolNamespace(), common::msgInterfaceFileName());
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
 
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -135,20 +139,16 @@ bool MsgInterface::writeProtocolDef()
            "};\n\n";
 
     common::writeProtocolNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 bool MsgInterface::writePluginHeader()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto& ns = common::pluginNamespaceNameStr();
     auto relPath = common::pathTo(ns, common::msgInterfaceFileName());
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -201,7 +201,7 @@ bool MsgInterface::writePluginHeader()
            "};\n";
 
     common::writePluginNamespaceEnd(protNs, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
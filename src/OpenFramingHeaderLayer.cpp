@@ -17,12 +17,12 @@
 
 #include "OpenFramingHeaderLayer.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -38,15 +38,11 @@ bool OpenFramingHeaderLayer::write()
 
 bool OpenFramingHeaderLayer::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(m_db.getProtocolNamespace(), common::openFramingHeaderLayerFileName());
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
 
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -419,7 +415,7 @@ bool OpenFramingHeaderLayer::writeProtocolDef()
 
 
     common::writeProtocolNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
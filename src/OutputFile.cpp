@@ -0,0 +1,57 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "OutputFile.h"
+
+#include <cassert>
+
+#include "DB.h"
+
+namespace sbe2comms
+{
+
+OutputFile::OutputFile(DB& db, const std::string& filePath)
+  : m_db(db),
+    m_filePath(filePath)
+{
+}
+
+OutputFile::~OutputFile() noexcept
+{
+    if (!m_finished) {
+        discard();
+    }
+}
+
+bool OutputFile::commit()
+{
+    assert(!m_finished);
+    m_finished = true;
+    if (!good()) {
+        return false;
+    }
+
+    return m_db.getGeneratedFiles().commit(m_filePath, str());
+}
+
+void OutputFile::discard()
+{
+    m_finished = true;
+    str(std::string());
+}
+
+} // namespace sbe2comms
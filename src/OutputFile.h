@@ -0,0 +1,57 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <sstream>
+
+namespace sbe2comms
+{
+
+class DB;
+
+/// \brief Output stream of a single generated file.
+/// \details The contents are accumulated in memory and handed over to
+///     \ref GeneratedFiles by \ref commit(), which writes the file only
+///     if its contents have changed. The contents that haven't been
+///     committed are dropped on destruction, so the writer failing halfway
+///     doesn't leave a truncated file behind.
+class OutputFile : public std::ostringstream
+{
+public:
+    OutputFile(DB& db, const std::string& filePath);
+    ~OutputFile() noexcept;
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    /// \brief Hand the accumulated contents over to be written.
+    /// \return \b false if the stream is in a failed state or the file
+    ///     couldn't be written.
+    bool commit();
+
+    /// \brief Drop the accumulated contents.
+    void discard();
+
+private:
+    DB& m_db;
+    std::string m_filePath;
+    bool m_finished = false;
+};
+
+} // namespace sbe2comms
@@ -0,0 +1,69 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+
+namespace sbe2comms
+{
+
+/// \brief Destination of the generated files.
+/// \details The paths are relative to the root of the sink and use '/'
+///     as a separator. The directories are expected to be created
+///     implicitly when the file is written. The functions can be invoked
+///     by multiple threads at the same time.
+class OutputSink
+{
+public:
+    virtual ~OutputSink() noexcept;
+
+    bool exists(const std::string& path)
+    {
+        return existsImpl(path);
+    }
+
+    bool read(const std::string& path, std::string& contents)
+    {
+        return readImpl(path, contents);
+    }
+
+    bool write(const std::string& path, const std::string& contents)
+    {
+        return writeImpl(path, contents);
+    }
+
+    bool remove(const std::string& path)
+    {
+        return removeImpl(path);
+    }
+
+    /// \brief Human readable location of the path, used in the log.
+    std::string location(const std::string& path) const
+    {
+        return locationImpl(path);
+    }
+
+protected:
+    virtual bool existsImpl(const std::string& path) = 0;
+    virtual bool readImpl(const std::string& path, std::string& contents) = 0;
+    virtual bool writeImpl(const std::string& path, const std::string& contents) = 0;
+    virtual bool removeImpl(const std::string& path) = 0;
+    virtual std::string locationImpl(const std::string& path) const;
+};
+
+} // namespace sbe2comms
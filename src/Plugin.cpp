@@ -17,13 +17,13 @@
 
 #include "Plugin.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "output.h"
 
 namespace bf = boost::filesystem;
@@ -34,10 +34,6 @@ namespace sbe2comms
 
 bool Plugin::write()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     return
         writeMetaFile(false) &&
         writeMetaFile(true) &&
@@ -61,7 +57,7 @@ bool Plugin::writeMetaFile(bool openFrame)
     auto relPath = common::pluginNamespaceNameStr() + '/' + "plugin_" + *name + ".json";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -77,7 +73,7 @@ bool Plugin::writeMetaFile(bool openFrame)
            output::indent(1) << "\"type\" : \"protocol\"\n"
            "}\n";
 
-    return true;
+    return out.commit();
 }
 
 bool Plugin::writeHeader(bool openFrame)
@@ -97,7 +93,7 @@ bool Plugin::writeHeader(bool openFrame)
     auto relPath = common::pluginNamespaceNameStr() + '/' + className + ".h";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -121,7 +117,7 @@ bool Plugin::writeHeader(bool openFrame)
            "};\n\n";
 
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 bool Plugin::writeSrc(bool openFrame)
@@ -136,7 +132,7 @@ bool Plugin::writeSrc(bool openFrame)
     auto relPath = common::pluginNamespaceNameStr() + '/' + className + ".cpp";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -161,7 +157,7 @@ bool Plugin::writeSrc(bool openFrame)
            "}\n\n" <<
            className << "::~" << className << "() = default;\n\n";
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
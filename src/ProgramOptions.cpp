@@ -19,8 +19,13 @@
 #include <iostream>
 #include <cassert>
 #include <vector>
+#include <algorithm>
+
+#include <boost/algorithm/string.hpp>
 
 namespace po = boost::program_options;
+namespace ba = boost::algorithm;
+
 namespace sbe2comms
 {
 
@@ -40,6 +45,19 @@ const std::string FullMinRemoteVerStr(MinRemoteVerStr + ",m");
 const std::string InputFileStr("input-file");
 const std::string CommsChampionTagStr("cc-tag");
 const std::string OpenFrameHeaderNameStr("sofh-name");
+const std::string JobsStr("jobs");
+const std::string FullJobsStr(JobsStr + ",j");
+const std::string IncrementalStr("incremental");
+const std::string WatchStr("watch");
+const std::string PruneTypesStr("prune-types");
+const std::string MessagesStr("messages");
+const std::string ComponentsStr("components");
+const std::string InstantiateStr("instantiate");
+const std::string LazyReadStr("lazy-read");
+const std::string ViewsStr("views");
+const std::string EncodersStr("encoders");
+const std::string StatsStr("stats");
+const std::string TraceFileStr("trace-file");
 
 po::options_description createDescription()
 {
@@ -47,7 +65,9 @@ po::options_description createDescription()
     desc.add_options()
         (FullHelpStr.c_str(), "This help.")
         (FullOutputDirStr.c_str(), po::value<std::string>()->default_value(std::string()),
-            "Output directory path. Empty means current.")
+            "Output directory path. Empty means current. When multiple schema files "
+            "are provided, every protocol is generated into the subdirectory named "
+            "after its namespace.")
         (FullNamespaceStr.c_str(), po::value<std::string>(),
             "Force protocol namespace. Defaults to package name defined in the schema.")
         (FullForceVerStr.c_str(), po::value<unsigned>(),
@@ -58,6 +78,45 @@ po::options_description createDescription()
             "Default tag/branch of the CommsChampion project.")
         (OpenFrameHeaderNameStr.c_str(), po::value<std::string>()->default_value(std::string()),
             "Name for Simple Open Framing Header definition \"composite\" type.")
+        (FullJobsStr.c_str(), po::value<unsigned>()->default_value(1U),
+            "Number of parallel code generation jobs. 0 means number of available cores.")
+        (IncrementalStr.c_str(), "Regenerate only messages and types, which definition "
+            "(or definition of the types they use) has changed since the previous incremental "
+            "run into the same output directory.")
+        (WatchStr.c_str(), "Keep running and regenerate the code every time the schema "
+            "files (or the files they include) are modified. Only the outputs affected "
+            "by the modification are regenerated.")
+        (MessagesStr.c_str(), po::value<std::string>(),
+            "Comma separated list of messages to generate, the names may contain "
+            "'*' and '?' wildcards. The types used only by the other messages are "
+            "not generated. Defaults to all the messages.")
+        (ComponentsStr.c_str(), po::value<std::string>(),
+            "Comma separated list of the components to generate: \"protocol\" (protocol "
+            "definition headers), \"plugin\" (CommsChampion plugin), \"doc\" (doxygen "
+            "documentation) and \"cmake\" (build files). The components required by the "
+            "selected ones are generated as well. Defaults to all the components.")
+        (InstantiateStr.c_str(), po::value<std::string>(),
+            "Options of the common interface class (for example \"comms::option::ReadIterator<const "
+            "std::uint8_t*>, comms::option::LengthInfoInterface\"), all the messages are "
+            "explicitly instantiated with. Generates extern template declarations, "
+            "source file with explicit instantiation for every message and static "
+            "library building them.")
+        (LazyReadStr.c_str(), "Allow the messages to postpone decoding of their groups "
+            "and data fields until they are accessed. The mode is selected at compile "
+            "time by the \"LazyRead\" type of the message options. Implies \"--views\".")
+        (ViewsStr.c_str(), "Generate zero-copy view class for every message, reading the fields "
+            "directly from the serialised buffer.")
+        (EncodersStr.c_str(), "Generate flyweight encoder class for every message, writing the "
+            "fields directly into the output buffer.")
+        (PruneTypesStr.c_str(), "Don't parse and generate the types, which are not "
+            "referenced (directly or indirectly) by any message, message header or "
+            "Simple Open Framing Header.")
+        (StatsStr.c_str(), "Print time, number of allocations and output size of every "
+            "generation phase, as well as the slowest messages and types. "
+            "Reported after every regeneration in the watch mode.")
+        (TraceFileStr.c_str(), po::value<std::string>(),
+            "Write timing of every phase, message and type into the provided file "
+            "in Chrome trace event format.")
     ;
     return desc;
 }
@@ -111,6 +170,19 @@ void ProgramOptions::parse(int argc, const char* argv[])
     po::notify(m_vm);
 }
 
+void ProgramOptions::parse(const std::vector<std::string>& args)
+{
+    po::options_description allOptions;
+    allOptions.add(getDescription()).add(getHidden());
+    auto parseResult =
+        po::command_line_parser(args)
+            .options(allOptions)
+            .positional(getPositional())
+            .run();
+    po::store(parseResult, m_vm);
+    po::notify(m_vm);
+}
+
 void ProgramOptions::printHelp(std::ostream& out)
 {
     out << getDescription() << std::endl;
@@ -121,15 +193,13 @@ bool ProgramOptions::helpRequested() const
     return 0 < m_vm.count(HelpStr);
 }
 
-std::string ProgramOptions::getFile() const
+std::vector<std::string> ProgramOptions::getFiles() const
 {
     if (m_vm.count(InputFileStr) == 0U) {
-        return std::string();
+        return std::vector<std::string>();
     }
 
-    auto inputs = m_vm[InputFileStr].as<std::vector<std::string> >();
-    assert(!inputs.empty());
-    return std::move(inputs[0]);
+    return m_vm[InputFileStr].as<std::vector<std::string> >();
 }
 
 std::string ProgramOptions::getOutputDirectory() const
@@ -172,6 +242,94 @@ std::string ProgramOptions::getOpenFramingHeaderName() const
     return m_vm[OpenFrameHeaderNameStr].as<std::string>();
 }
 
+unsigned ProgramOptions::getJobsCount() const
+{
+    return m_vm[JobsStr].as<unsigned>();
+}
+
+bool ProgramOptions::incrementalRequested() const
+{
+    return 0 < m_vm.count(IncrementalStr);
+}
+
+bool ProgramOptions::watchRequested() const
+{
+    return 0 < m_vm.count(WatchStr);
+}
+
+std::vector<std::string> ProgramOptions::getMessages() const
+{
+    return getList(MessagesStr);
+}
+
+std::vector<std::string> ProgramOptions::getComponents() const
+{
+    return getList(ComponentsStr);
+}
+
+bool ProgramOptions::hasInstantiateOptions() const
+{
+    return 0 < m_vm.count(InstantiateStr);
+}
+
+std::string ProgramOptions::getInstantiateOptions() const
+{
+    return m_vm[InstantiateStr].as<std::string>();
+}
+
+bool ProgramOptions::lazyReadRequested() const
+{
+    return 0 < m_vm.count(LazyReadStr);
+}
+
+bool ProgramOptions::viewsRequested() const
+{
+    return 0 < m_vm.count(ViewsStr);
+}
+
+bool ProgramOptions::encodersRequested() const
+{
+    return 0 < m_vm.count(EncodersStr);
+}
+
+bool ProgramOptions::pruneTypesRequested() const
+{
+    return 0 < m_vm.count(PruneTypesStr);
+}
+
+bool ProgramOptions::statsRequested() const
+{
+    return 0 < m_vm.count(StatsStr);
+}
+
+bool ProgramOptions::hasTraceFile() const
+{
+    return 0 < m_vm.count(TraceFileStr);
+}
+
+std::string ProgramOptions::getTraceFile() const
+{
+    return m_vm[TraceFileStr].as<std::string>();
+}
+
+std::vector<std::string> ProgramOptions::getList(const std::string& opt) const
+{
+    std::vector<std::string> result;
+    if (m_vm.count(opt) == 0U) {
+        return result;
+    }
+
+    auto& value = m_vm[opt].as<std::string>();
+    ba::split(result, value, ba::is_any_of(","));
+    for (auto& elem : result) {
+        ba::trim(elem);
+    }
+
+    result.erase(
+        std::remove(result.begin(), result.end(), std::string()),
+        result.end());
+    return result;
+}
 
 // namespace
 
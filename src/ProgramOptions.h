@@ -18,6 +18,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <iosfwd>
 #include <boost/program_options.hpp>
 
@@ -28,10 +29,14 @@ class ProgramOptions
 {
 public:
     void parse(int argc, const char* argv[]);
+
+    /// \brief Parse the options without the program name, used when the
+    ///     generator is embedded as a library.
+    void parse(const std::vector<std::string>& args);
     static void printHelp(std::ostream& out);
 
     bool helpRequested() const;
-    std::string getFile() const;
+    std::vector<std::string> getFiles() const;
     std::string getOutputDirectory() const;
     bool hasNamespaceOverride() const;
     std::string getNamespace() const;
@@ -40,7 +45,23 @@ public:
     unsigned getMinRemoteVersion() const;
     std::string getCommsChampionTag() const;
     std::string getOpenFramingHeaderName() const;
+    unsigned getJobsCount() const;
+    bool incrementalRequested() const;
+    bool watchRequested() const;
+    std::vector<std::string> getMessages() const;
+    std::vector<std::string> getComponents() const;
+    bool hasInstantiateOptions() const;
+    std::string getInstantiateOptions() const;
+    bool lazyReadRequested() const;
+    bool viewsRequested() const;
+    bool encodersRequested() const;
+    bool pruneTypesRequested() const;
+    bool statsRequested() const;
+    bool hasTraceFile() const;
+    std::string getTraceFile() const;
 private:
+    std::vector<std::string> getList(const std::string& opt) const;
+
     boost::program_options::variables_map m_vm;
 };
 
@@ -17,12 +17,12 @@
 
 #include "Protocol.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "output.h"
 
 namespace bf = boost::filesystem;
@@ -32,10 +32,6 @@ namespace sbe2comms
 
 bool Protocol::write()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     return
         writeHeader() &&
         writeSrc(common::messageHeaderFrameStr()) &&
@@ -47,7 +43,7 @@ bool Protocol::writeHeader()
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::protocolNameStr() + ".h";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -80,7 +76,7 @@ bool Protocol::writeHeader()
            output::indent(1) << "std::unique_ptr<ProtocolImpl> m_pImpl;\n"
            "};\n\n";
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 bool Protocol::writeSrc(const std::string& name)
@@ -88,7 +84,7 @@ bool Protocol::writeSrc(const std::string& name)
     auto relPath = common::pluginNamespaceNameStr() + '/' + name + common::protocolNameStr() + ".cpp";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -180,7 +176,7 @@ bool Protocol::writeSrc(const std::string& name)
            "}\n\n";
 
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
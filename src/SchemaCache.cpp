@@ -0,0 +1,241 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "SchemaCache.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "log.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+const std::string XIncludeNs("http://www.w3.org/2001/XInclude");
+const std::string XIncludeOldNs("http://www.w3.org/2003/XInclude");
+const std::string IncludeStr("include");
+const std::string HrefStr("href");
+const std::string ParseStr("parse");
+const std::string XpointerStr("xpointer");
+
+bool isInclude(xmlNodePtr node)
+{
+    if ((node->ns == nullptr) || (node->ns->href == nullptr)) {
+        return false;
+    }
+
+    auto* href = reinterpret_cast<const char*>(node->ns->href);
+    if ((XIncludeNs != href) && (XIncludeOldNs != href)) {
+        return false;
+    }
+
+    return IncludeStr == reinterpret_cast<const char*>(node->name);
+}
+
+std::string dirOf(const std::string& path)
+{
+    return bf::path(path).parent_path().string();
+}
+
+std::string normalisedPath(const std::string& dir, const std::string& file)
+{
+    bf::path path(file);
+    if (path.is_relative() && (!dir.empty())) {
+        path = bf::path(dir) / path;
+    }
+
+    boost::system::error_code ec;
+    auto canonical = bf::canonical(path, ec);
+    if (ec) {
+        return path.lexically_normal().string();
+    }
+
+    return canonical.string();
+}
+
+} // namespace
+
+XmlDocPtr SchemaCache::load(const std::string& filename)
+{
+    XmlDocPtr doc(xmlReadFile(filename.c_str(), nullptr, 0));
+    return resolve(std::move(doc), filename);
+}
+
+XmlDocPtr SchemaCache::loadMemory(const std::string& contents, const std::string& name)
+{
+    XmlDocPtr doc(xmlReadMemory(contents.c_str(), static_cast<int>(contents.size()), name.c_str(), nullptr, 0));
+    return resolve(std::move(doc), name);
+}
+
+bool SchemaCache::addFile(const std::string& path, const std::string& contents)
+{
+    XmlDocPtr doc(xmlReadMemory(contents.c_str(), static_cast<int>(contents.size()), path.c_str(), nullptr, 0));
+    if (!doc) {
+        log::error() << "Invalid included file \"" << path << "\"!" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto& entryPtr = m_entries[normalisedPath(std::string(), path)];
+    entryPtr.reset(new Entry);
+    entryPtr->m_doc = std::move(doc);
+    entryPtr->m_loaded = true;
+    return true;
+}
+
+XmlDocPtr SchemaCache::resolve(XmlDocPtr doc, const std::string& filename)
+{
+    if (!doc) {
+        return doc;
+    }
+
+    auto* root = xmlDocGetRootElement(doc.get());
+    if (root == nullptr) {
+        return doc;
+    }
+
+    IncludeChain chain(1U, normalisedPath(std::string(), filename));
+    if (!resolveIncludes(root, doc.get(), dirOf(filename), chain)) {
+        return XmlDocPtr();
+    }
+
+    return doc;
+}
+
+SchemaCache::FilesList SchemaCache::getIncludedFiles()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    FilesList result;
+    result.reserve(m_entries.size());
+    for (auto& e : m_entries) {
+        result.push_back(e.first);
+    }
+    return result;
+}
+
+xmlDocPtr SchemaCache::getInclude(const std::string& path, IncludeChain& chain)
+{
+    if (std::find(chain.begin(), chain.end(), path) != chain.end()) {
+        log::error() << "Recursive inclusion of \"" << path << "\"!" << std::endl;
+        return nullptr;
+    }
+
+    Entry* entry = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto& entryPtr = m_entries[path];
+        if (!entryPtr) {
+            entryPtr.reset(new Entry);
+        }
+        entry = entryPtr.get();
+    }
+
+    // The nested inclusions are resolved in the copy of the document,
+    // there is no need to hold the lock of more than one entry.
+    std::lock_guard<std::mutex> guard(entry->m_mutex);
+    if (!entry->m_loaded) {
+        entry->m_doc.reset(xmlReadFile(path.c_str(), nullptr, 0));
+        entry->m_loaded = true;
+    }
+
+    if (!entry->m_doc) {
+        log::error() << "Failed to load included file \"" << path << "\"!" << std::endl;
+        return nullptr;
+    }
+
+    return entry->m_doc.get();
+}
+
+bool SchemaCache::resolveIncludes(
+    xmlNodePtr node,
+    xmlDocPtr doc,
+    const std::string& dir,
+    IncludeChain& chain)
+{
+    assert(node != nullptr);
+    auto* cur = node->children;
+    while (cur != nullptr) {
+        auto* next = cur->next;
+        do {
+            if (cur->type != XML_ELEMENT_NODE) {
+                break;
+            }
+
+            if (!isInclude(cur)) {
+                if (!resolveIncludes(cur, doc, dir, chain)) {
+                    return false;
+                }
+                break;
+            }
+
+            auto props = xmlParseNodeProps(cur, doc);
+            auto parseIter = props.find(ParseStr);
+            if (((parseIter != props.end()) && (parseIter->second != "xml")) ||
+                (props.find(XpointerStr) != props.end())) {
+                log::error() << "Only inclusion of the whole XML files is supported!" << std::endl;
+                return false;
+            }
+
+            auto hrefIter = props.find(HrefStr);
+            if ((hrefIter == props.end()) || (hrefIter->second.empty())) {
+                log::error() << "XInclude directive without \"" << HrefStr << "\" property!" << std::endl;
+                return false;
+            }
+
+            auto path = normalisedPath(dir, hrefIter->second);
+            auto* included = getInclude(path, chain);
+            if (included == nullptr) {
+                return false;
+            }
+
+            auto* includedRoot = xmlDocGetRootElement(included);
+            if (includedRoot == nullptr) {
+                log::error() << "Included file \"" << path << "\" is empty!" << std::endl;
+                return false;
+            }
+
+            auto* copy = xmlDocCopyNode(includedRoot, doc, 1);
+            if (copy == nullptr) {
+                return false;
+            }
+
+            xmlAddPrevSibling(cur, copy);
+            xmlUnlinkNode(cur);
+            xmlFreeNode(cur);
+
+            chain.push_back(path);
+            bool resolved = resolveIncludes(copy, doc, dirOf(path), chain);
+            chain.pop_back();
+            if (!resolved) {
+                return false;
+            }
+        } while (false);
+
+        cur = next;
+    }
+
+    return true;
+}
+
+} // namespace sbe2comms
@@ -0,0 +1,69 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "xml_wrap.h"
+
+namespace sbe2comms
+{
+
+/// \brief Cache of the schema files shared between multiple schemas.
+/// \details Loads the schemas resolving their XInclude directives. Every
+///     included file (usually definition of the common types) is parsed
+///     only once and its contents are copied into every schema document
+///     referencing it. The contents of the included files can also be
+///     provided in memory with addFile(). Can be used by multiple threads
+///     at the same time.
+class SchemaCache
+{
+public:
+    using FilesList = std::vector<std::string>;
+
+    XmlDocPtr load(const std::string& filename);
+    XmlDocPtr loadMemory(const std::string& contents, const std::string& name);
+    bool addFile(const std::string& path, const std::string& contents);
+    FilesList getIncludedFiles();
+
+private:
+    using IncludeChain = std::vector<std::string>;
+
+    struct Entry
+    {
+        std::mutex m_mutex;
+        XmlDocPtr m_doc;
+        bool m_loaded = false;
+    };
+
+    using EntryPtr = std::unique_ptr<Entry>;
+    using EntriesMap = std::map<std::string, EntryPtr>;
+
+    XmlDocPtr resolve(XmlDocPtr doc, const std::string& filename);
+    xmlDocPtr getInclude(const std::string& path, IncludeChain& chain);
+    bool resolveIncludes(xmlNodePtr node, xmlDocPtr doc, const std::string& dir, IncludeChain& chain);
+
+    std::mutex m_mutex;
+    EntriesMap m_entries;
+};
+
+} // namespace sbe2comms
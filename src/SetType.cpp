@@ -272,7 +272,7 @@ void SetType::writeList(
 
 bool SetType::readChoices()
 {
-    static const std::string ElementStr("choice");
+    static const char* ElementStr = "choice";
     auto choices = xmlChildren(getNode(), ElementStr);
     if (choices.empty()) {
         log::error() << "No choice has been specified for set \"" << getName() << "\"" << std::endl;
@@ -0,0 +1,155 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "TarSink.h"
+
+#include <ostream>
+#include <cstring>
+#include <algorithm>
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+const std::size_t BlockSize = 512U;
+const std::size_t NameLen = 100U;
+const std::size_t PrefixLen = 155U;
+
+const std::size_t ModeOffset = 100U;
+const std::size_t UidOffset = 108U;
+const std::size_t GidOffset = 116U;
+const std::size_t SizeOffset = 124U;
+const std::size_t MtimeOffset = 136U;
+const std::size_t ChecksumOffset = 148U;
+const std::size_t ChecksumLen = 8U;
+const std::size_t TypeOffset = 156U;
+const std::size_t MagicOffset = 257U;
+const std::size_t PrefixOffset = 345U;
+
+// Zero padded octal number terminated by NUL character
+void writeOctal(char* field, std::size_t len, unsigned long long value)
+{
+    field[len - 1U] = '\0';
+    for (auto idx = len - 1U; 0U < idx; --idx) {
+        field[idx - 1U] = static_cast<char>('0' + (value & 0x7));
+        value >>= 3U;
+    }
+}
+
+bool splitPath(const std::string& path, std::string& prefix, std::string& name)
+{
+    if (path.size() <= NameLen) {
+        name = path;
+        return true;
+    }
+
+    auto pos = path.find('/', path.size() - NameLen - 1U);
+    if ((pos == std::string::npos) || (PrefixLen < pos)) {
+        return false;
+    }
+
+    prefix = path.substr(0, pos);
+    name = path.substr(pos + 1U);
+    return true;
+}
+
+} // namespace
+
+TarSink::TarSink(std::ostream& out)
+  : m_out(out)
+{
+}
+
+TarSink::~TarSink() noexcept
+{
+    finish();
+}
+
+bool TarSink::finish()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (!m_finished) {
+        static const char Zeroes[BlockSize * 2] = {0};
+        m_out.write(Zeroes, sizeof(Zeroes));
+        m_out.flush();
+        m_finished = true;
+    }
+    return m_out.good();
+}
+
+bool TarSink::existsImpl(const std::string& path)
+{
+    static_cast<void>(path);
+    return false;
+}
+
+bool TarSink::readImpl(const std::string& path, std::string& contents)
+{
+    static_cast<void>(path);
+    static_cast<void>(contents);
+    return false;
+}
+
+bool TarSink::writeImpl(const std::string& path, const std::string& contents)
+{
+    std::string prefix;
+    std::string name;
+    if (!splitPath(path, prefix, name)) {
+        return false;
+    }
+
+    char header[BlockSize] = {0};
+    std::memcpy(&header[0], name.c_str(), name.size());
+    writeOctal(&header[ModeOffset], 8U, 0644);
+    writeOctal(&header[UidOffset], 8U, 0);
+    writeOctal(&header[GidOffset], 8U, 0);
+    writeOctal(&header[SizeOffset], 12U, contents.size());
+    writeOctal(&header[MtimeOffset], 12U, 0);
+    header[TypeOffset] = '0';
+    std::memcpy(&header[MagicOffset], "ustar\0" "00", 8U);
+    std::memcpy(&header[PrefixOffset], prefix.c_str(), prefix.size());
+
+    std::fill_n(&header[ChecksumOffset], ChecksumLen, ' ');
+    unsigned checksum = 0U;
+    for (auto c : header) {
+        checksum += static_cast<unsigned char>(c);
+    }
+    writeOctal(&header[ChecksumOffset], 7U, checksum);
+
+    auto padding = (BlockSize - (contents.size() % BlockSize)) % BlockSize;
+    static const char Zeroes[BlockSize] = {0};
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_finished) {
+        return false;
+    }
+
+    m_out.write(header, sizeof(header));
+    m_out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    m_out.write(Zeroes, static_cast<std::streamsize>(padding));
+    return m_out.good();
+}
+
+bool TarSink::removeImpl(const std::string& path)
+{
+    static_cast<void>(path);
+    return false;
+}
+
+} // namespace sbe2comms
@@ -0,0 +1,52 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <mutex>
+
+#include "OutputSink.h"
+
+namespace sbe2comms
+{
+
+/// \brief Streams the generated files as a tar (ustar) archive.
+/// \details The archive is write only, the previously generated files
+///     are never reported as existing. The archive is terminated by
+///     finish() or on destruction.
+class TarSink : public OutputSink
+{
+public:
+    explicit TarSink(std::ostream& out);
+    ~TarSink() noexcept;
+
+    bool finish();
+
+protected:
+    virtual bool existsImpl(const std::string& path) override;
+    virtual bool readImpl(const std::string& path, std::string& contents) override;
+    virtual bool writeImpl(const std::string& path, const std::string& contents) override;
+    virtual bool removeImpl(const std::string& path) override;
+
+private:
+    std::mutex m_mutex;
+    std::ostream& m_out;
+    bool m_finished = false;
+};
+
+} // namespace sbe2comms
@@ -17,12 +17,12 @@
 
 #include "TransportFrame.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "prop.h"
 #include "output.h"
 
@@ -33,20 +33,24 @@ namespace sbe2comms
 
 bool TransportFrame::write()
 {
-    return writeProtocolDef() && writePluginDef();
+    if (!writeProtocolDef()) {
+        return false;
+    }
+
+    if (!m_db.isComponentEnabled(DB::Component::Plugin)) {
+        return true;
+    }
+
+    return writePluginDef();
 }
 
 bool TransportFrame::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace())) {
-        return false;
-    }
-
     auto relPath = common::protocolDirRelPath(m_db.getProtocolNamespace(), common::transportFrameFileName());
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
 
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -133,19 +137,15 @@ bool TransportFrame::writeProtocolDef()
            output::indent(1) << ">;\n\n";
 
     common::writeProtocolNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 bool TransportFrame::writePluginDef()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::transportFrameFileName();
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -174,7 +174,7 @@ bool TransportFrame::writePluginDef()
            output::indent(1) << ">;\n\n";
 
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
@@ -17,12 +17,12 @@
 
 #include "TransportMessage.h"
 
-#include <fstream>
 #include <boost/filesystem.hpp>
 
 #include "DB.h"
 #include "common.h"
 #include "log.h"
+#include "OutputFile.h"
 #include "output.h"
 
 namespace bf = boost::filesystem;
@@ -64,14 +64,10 @@ bool TransportMessage::write()
 
 bool TransportMessage::writePluginHeader(const std::string& name)
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto relPath = common::pluginNamespaceNameStr() + '/' + name + common::transportMessageNameStr() + ".h";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -99,19 +95,15 @@ bool TransportMessage::writePluginHeader(const std::string& name)
            "};\n\n";
 
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 bool TransportMessage::writeMessageHeaderSrc()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::messageHeaderFrameStr() + common::transportMessageNameStr() + ".cpp";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -147,19 +139,15 @@ bool TransportMessage::writeMessageHeaderSrc()
            output::indent(1) << "return Props;\n" <<
            "}\n\n";
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 bool TransportMessage::writeOpenFramingHeaderSrc()
 {
-    if (!common::createPluginDefDir(m_db.getRootPath())) {
-        return false;
-    }
-
     auto relPath = common::pluginNamespaceNameStr() + '/' + common::openFramingHeaderFrameStr() + common::transportMessageNameStr() + ".cpp";
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
     log::info() << "Generating " << relPath << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -231,7 +219,7 @@ bool TransportMessage::writeOpenFramingHeaderSrc()
            output::indent(1) << "return Props;\n" <<
            "}\n\n";
     common::writePluginNamespaceEnd(ns, out);
-    return true;
+    return out.commit();
 }
 
 } // namespace sbe2comms
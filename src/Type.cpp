@@ -18,7 +18,6 @@
 #include "Type.h"
 
 #include <iostream>
-#include <fstream>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
@@ -32,6 +31,7 @@
 #include "SetType.h"
 #include "RefType.h"
 #include "log.h"
+#include "OutputFile.h"
 
 namespace bf = boost::filesystem;
 namespace ba = boost::algorithm;
@@ -278,10 +278,6 @@ Type::Ptr Type::create(DB& db, xmlNodePtr node)
 
 bool Type::writeProtocolDef()
 {
-    if (!common::createProtocolDefDir(m_db.getRootPath(), m_db.getProtocolNamespace(), common::fieldDirName())) {
-        return false;
-    }
-
     auto fieldDirRelPath =
             common::protocolDirRelPath(m_db.getProtocolNamespace(), common::fieldDirName());
 
@@ -291,7 +287,7 @@ bool Type::writeProtocolDef()
     auto filePath = bf::path(m_db.getRootPath()) / relPath;
 
     log::info() << "Generating " << relPath.string() << std::endl;
-    std::ofstream out(filePath.string());
+    OutputFile out(m_db, filePath.string());
     if (!out) {
         log::error() << "Failed to create " << filePath.string() << std::endl;
         return false;
@@ -302,7 +298,7 @@ bool Type::writeProtocolDef()
     openNamespaces(out, m_db);
     bool result = write(out);
     closeNamespaces(out, m_db);
-    return result && out.good();
+    return result && out.commit();
 }
 
 bool Type::write(std::ostream& out, unsigned indent)
@@ -156,6 +156,11 @@ public:
         return getRealTypeImpl();
     }
 
+    const Type* getRealType() const
+    {
+        return const_cast<Type*>(this)->getRealTypeImpl();
+    }
+
 protected:
 
     DB& getDb()
@@ -0,0 +1,203 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Watcher.h"
+
+#include <thread>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include <boost/filesystem.hpp>
+
+#include "log.h"
+
+namespace bf = boost::filesystem;
+
+namespace sbe2comms
+{
+
+namespace
+{
+
+// Editors usually write the file several times when saving it,
+// report the whole burst of modifications as a single change.
+const unsigned SettleMs = 100U;
+
+std::string canonicalPath(const std::string& file)
+{
+    boost::system::error_code ec;
+    auto path = bf::canonical(file, ec);
+    if (ec) {
+        return bf::absolute(file).lexically_normal().string();
+    }
+    return path.string();
+}
+
+} // namespace
+
+#ifdef __linux__
+
+Watcher::Watcher()
+  : m_fd(inotify_init1(IN_CLOEXEC))
+{
+}
+
+Watcher::~Watcher() noexcept
+{
+    if (0 <= m_fd) {
+        close(m_fd);
+    }
+}
+
+bool Watcher::watch(const std::string& file)
+{
+    if (m_fd < 0) {
+        log::error() << "Failed to initialise inotify!" << std::endl;
+        return false;
+    }
+
+    auto path = canonicalPath(file);
+    if (!m_files.insert(std::make_pair(path, 0)).second) {
+        return true;
+    }
+
+    // Watch the directory rather than the file itself, the editors
+    // often replace the file instead of modifying it.
+    auto dir = bf::path(path).parent_path().string();
+    static const std::uint32_t Mask =
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+    auto wd = inotify_add_watch(m_fd, dir.c_str(), Mask);
+    if (wd < 0) {
+        log::error() << "Failed to watch " << dir << std::endl;
+        return false;
+    }
+
+    m_dirs[wd] = dir;
+    return true;
+}
+
+bool Watcher::waitForChange()
+{
+    bool changed = false;
+    while (!changed) {
+        if (!readEvents(changed)) {
+            return false;
+        }
+    }
+
+    while (true) {
+        pollfd pfd;
+        pfd.fd = m_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        auto count = poll(&pfd, 1, static_cast<int>(SettleMs));
+        if (count <= 0) {
+            break;
+        }
+
+        if (!readEvents(changed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Watcher::readEvents(bool& changed)
+{
+    alignas(inotify_event) char buf[4096];
+    auto len = read(m_fd, buf, sizeof(buf));
+    if (len <= 0) {
+        log::error() << "Failed to read inotify events!" << std::endl;
+        return false;
+    }
+
+    auto* pos = buf;
+    while (pos < (buf + len)) {
+        auto* event = reinterpret_cast<const inotify_event*>(pos);
+        pos += sizeof(inotify_event) + event->len;
+
+        auto iter = m_dirs.find(event->wd);
+        if ((iter == m_dirs.end()) || (event->len == 0U)) {
+            continue;
+        }
+
+        auto path = (bf::path(iter->second) / event->name).string();
+        if (m_files.find(path) != m_files.end()) {
+            changed = true;
+        }
+    }
+    return true;
+}
+
+#else // #ifdef __linux__
+
+namespace
+{
+
+std::time_t modificationTime(const std::string& file)
+{
+    boost::system::error_code ec;
+    auto result = bf::last_write_time(file, ec);
+    if (ec) {
+        return 0;
+    }
+    return result;
+}
+
+} // namespace
+
+Watcher::Watcher() = default;
+Watcher::~Watcher() noexcept = default;
+
+bool Watcher::watch(const std::string& file)
+{
+    auto path = canonicalPath(file);
+    m_files.insert(std::make_pair(path, modificationTime(path)));
+    return true;
+}
+
+bool Watcher::waitForChange()
+{
+    static const unsigned PollMs = 500U;
+    bool changed = false;
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(changed ? SettleMs : PollMs));
+        bool modified = false;
+        for (auto& f : m_files) {
+            auto time = modificationTime(f.first);
+            if (time != f.second) {
+                f.second = time;
+                modified = true;
+            }
+        }
+
+        if (changed && (!modified)) {
+            return true;
+        }
+
+        changed = changed || modified;
+    }
+}
+
+#endif // #ifdef __linux__
+
+} // namespace sbe2comms
@@ -0,0 +1,57 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <ctime>
+
+namespace sbe2comms
+{
+
+/// \brief Detects modifications of the schema files.
+/// \details Uses inotify on Linux, the changes made between the calls to
+///     waitForChange() are not lost. Other platforms poll the modification
+///     times of the files.
+class Watcher
+{
+public:
+    Watcher();
+    ~Watcher() noexcept;
+
+    Watcher(const Watcher&) = delete;
+    Watcher& operator=(const Watcher&) = delete;
+
+    bool watch(const std::string& file);
+    bool waitForChange();
+
+private:
+    using FilesMap = std::map<std::string, std::time_t>;
+
+    FilesMap m_files;
+#ifdef __linux__
+    using DirsMap = std::map<int, std::string>;
+
+    bool readEvents(bool& changed);
+
+    DirsMap m_dirs;
+    int m_fd = -1;
+#endif
+};
+
+} // namespace sbe2comms
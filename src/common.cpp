@@ -79,6 +79,12 @@ const std::string& includeDirName()
     return Name;
 }
 
+const std::string& srcDirName()
+{
+    static const std::string Name("src");
+    return Name;
+}
+
 const std::string& defaultOptionsFileName()
 {
     static const std::string Name(defaultOptionsStr() + ".h");
@@ -403,6 +409,18 @@ const std::string& numInGroupStr()
     return Str;
 }
 
+const std::string& boundedGroupStorageStr()
+{
+    static const std::string Str("BoundedGroupStorage");
+    return Str;
+}
+
+const std::string& boundedDataStorageStr()
+{
+    static const std::string Str("BoundedDataStorage");
+    return Str;
+}
+
 const std::string& groupListStr()
 {
     static const std::string Str("groupList");
@@ -559,6 +577,78 @@ const std::string& messageSchemaFileNameStr()
     return Str;
 }
 
+const std::string& msgFactoryStr()
+{
+    static const std::string Str("MsgFactory");
+    return Str;
+}
+
+const std::string& msgFactoryFileName()
+{
+    static const std::string Str(msgFactoryStr() + ".h");
+    return Str;
+}
+
+const std::string& instantiatedMessageStr()
+{
+    static const std::string Str("InstantiatedMessage");
+    return Str;
+}
+
+const std::string& instantiatedMessagesFileName()
+{
+    static const std::string Str(instantiatedMessageStr() + "s.h");
+    return Str;
+}
+
+const std::string& viewStr()
+{
+    static const std::string Str("View");
+    return Str;
+}
+
+const std::string& viewFileName()
+{
+    static const std::string Str(viewStr() + ".h");
+    return Str;
+}
+
+const std::string& encoderStr()
+{
+    static const std::string Str("Encoder");
+    return Str;
+}
+
+const std::string& encoderFileName()
+{
+    static const std::string Str(encoderStr() + ".h");
+    return Str;
+}
+
+const std::string& projectionStr()
+{
+    static const std::string Str("Projection");
+    return Str;
+}
+
+const std::string& projectionFileName()
+{
+    static const std::string Str(projectionStr() + ".h");
+    return Str;
+}
+
+const std::string& lazyReadStr()
+{
+    static const std::string Str("LazyRead");
+    return Str;
+}
+
+const std::string& lazyReadFileName()
+{
+    static const std::string Str(lazyReadStr() + ".h");
+    return Str;
+}
+
 std::string num(std::intmax_t val)
 {
     if (std::numeric_limits<std::int32_t>::max() < val) {
@@ -945,48 +1035,6 @@ std::string protocolDirRelPath(const std::string& ns, const std::string& extraDi
     return path.string();
 }
 
-bool createProtocolDefDir(
-    const std::string& root,
-    const std::string& ns,
-    const std::string& extraDir)
-{
-    bf::path rootPath(root);
-    bf::path protocolRelDir(protocolDirRelPath(ns, extraDir));
-
-    bf::path protocolDir = rootPath / protocolRelDir;
-
-    boost::system::error_code ec;
-    bf::create_directories(protocolDir, ec);
-    if (ec) {
-        log::error() << "Failed to create \"" << protocolRelDir.string() <<
-                "\" with error \"" << ec.message() << "\"!" << std::endl;
-        return false;
-    }
-    return true;
-}
-
-bool createPluginDefDir(
-    const std::string& root,
-    const std::string& extraDir)
-{
-    bf::path rootPath(root);
-    bf::path dir(pluginNamespaceNameStr());
-    if (!extraDir.empty()) {
-        dir /= extraDir;
-    }
-
-    bf::path fullPath = rootPath / dir;
-
-    boost::system::error_code ec;
-    bf::create_directories(fullPath, ec);
-    if (ec) {
-        log::error() << "Failed to create \"" << dir.string() <<
-                "\" with error \"" << ec.message() << "\"!" << std::endl;
-        return false;
-    }
-    return true;
-}
-
 std::pair<std::intmax_t, bool> intMinValue(const std::string& type, const std::string& value)
 {
     try {
@@ -1116,6 +1164,44 @@ std::string localHeader(const std::string& ns, const std::string& path)
     return localHeader(ns, emptyString(), path);
 }
 
+bool wildcardMatch(const std::string& pattern, const std::string& value)
+{
+    // '*' matches any sequence, '?' matches any single character
+    std::size_t patPos = 0U;
+    std::size_t valPos = 0U;
+    std::size_t starPos = std::string::npos;
+    std::size_t starValPos = 0U;
+    while (valPos < value.size()) {
+        if ((patPos < pattern.size()) &&
+            ((pattern[patPos] == '?') || (pattern[patPos] == value[valPos]))) {
+            ++patPos;
+            ++valPos;
+            continue;
+        }
+
+        if ((patPos < pattern.size()) && (pattern[patPos] == '*')) {
+            starPos = patPos;
+            starValPos = valPos;
+            ++patPos;
+            continue;
+        }
+
+        if (starPos == std::string::npos) {
+            return false;
+        }
+
+        patPos = starPos + 1U;
+        ++starValPos;
+        valPos = starValPos;
+    }
+
+    while ((patPos < pattern.size()) && (pattern[patPos] == '*')) {
+        ++patPos;
+    }
+
+    return patPos == pattern.size();
+}
+
 } // namespace common
 
 } // namespace sbe2comms
@@ -35,6 +35,7 @@ const std::string& fieldDirName();
 const std::string& fieldHeaderFileName();
 const std::string& fieldDefFileName();
 const std::string& includeDirName();
+const std::string& srcDirName();
 const std::string& defaultOptionsFileName();
 const std::string& msgIdFileName();
 const std::string& msgInterfaceFileName();
@@ -69,6 +70,8 @@ const std::string& optParamPrefixStr();
 const std::string& blockLengthStr();
 const std::string& numInGroupStr();
 const std::string& groupListStr();
+const std::string& boundedGroupStorageStr();
+const std::string& boundedDataStorageStr();
 const std::string& templateIdStr();
 const std::string& schemaIdStr();
 const std::string& versionStr();
@@ -94,6 +97,18 @@ const std::string& pluginNameStr();
 const std::string& serialisedHiddenStr();
 const std::string& messageSchemaStr();
 const std::string& messageSchemaFileNameStr();
+const std::string& instantiatedMessageStr();
+const std::string& msgFactoryStr();
+const std::string& msgFactoryFileName();
+const std::string& instantiatedMessagesFileName();
+const std::string& viewStr();
+const std::string& viewFileName();
+const std::string& encoderStr();
+const std::string& encoderFileName();
+const std::string& projectionStr();
+const std::string& projectionFileName();
+const std::string& lazyReadStr();
+const std::string& lazyReadFileName();
 std::string num(std::intmax_t val);
 std::string num(std::uintmax_t val);
 std::string scopeFor(const std::string& ns, const std::string type);
@@ -139,14 +154,6 @@ void recordExtraHeader(const std::string& newHeader, std::set<std::string>& allH
 
 std::string protocolDirRelPath(const std::string& ns, const std::string& extraDir = std::string());
 
-bool createProtocolDefDir(
-    const std::string& root,
-    const std::string& ns,
-    const std::string& extraDir = std::string());
-bool createPluginDefDir(
-    const std::string& root,
-    const std::string& extraDir = std::string());
-
 std::pair<std::intmax_t, bool> intMinValue(const std::string& type, const std::string& value = std::string());
 std::pair<std::intmax_t, bool> intMaxValue(const std::string& type, const std::string& value = std::string());
 std::pair<std::uintmax_t, bool> intBigUnsignedMaxValue(const std::string& value = std::string());
@@ -157,6 +164,7 @@ void scopeToPropertyDefNames(
     bool commsOptionalWrapped,
     std::string* fieldType,
     std::string* propsName);
+bool wildcardMatch(const std::string& pattern, const std::string& value);
 
 } // namespace common
 
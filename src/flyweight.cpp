@@ -0,0 +1,321 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "flyweight.h"
+
+#include <iostream>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+
+#include <boost/algorithm/string.hpp>
+
+#include "DB.h"
+#include "BasicField.h"
+#include "GroupField.h"
+#include "DataField.h"
+#include "BasicType.h"
+#include "CompositeType.h"
+#include "EnumType.h"
+#include "common.h"
+#include "log.h"
+
+namespace ba = boost::algorithm;
+
+namespace sbe2comms
+{
+
+namespace flyweight
+{
+
+namespace
+{
+
+const std::string& unsignedTypeFor(std::size_t len)
+{
+    static const std::string Types[] = {
+        "std::uint8_t",
+        "std::uint16_t",
+        common::emptyString(),
+        "std::uint32_t",
+        common::emptyString(),
+        common::emptyString(),
+        common::emptyString(),
+        "std::uint64_t"
+    };
+
+    if ((len == 0U) || (std::extent<decltype(Types)>::value < len)) {
+        return common::emptyString();
+    }
+
+    return Types[len - 1];
+}
+
+bool isPaddingMember(const std::string& name)
+{
+    return ba::starts_with(name, common::padStr()) && ba::ends_with(name, "_");
+}
+
+// Limit of the length / count member, the maxValue specified in the schema
+// takes precedence over the range of the serialised type.
+std::string maxCountStr(const Type& type, const std::string& cppType)
+{
+    auto& maxValue = type.getMaxValue();
+    if ((type.getKind() == Type::Kind::Basic) && (!maxValue.empty())) {
+        auto& primType = asBasicType(type).getPrimitiveType();
+        auto maxVal = common::intMaxValue(primType, maxValue);
+        auto typeMax = common::intMaxValue(primType);
+        bool fits = (!typeMax.second) || (maxVal.first <= typeMax.first);
+        if (maxVal.second && (0 <= maxVal.first) && fits) {
+            return std::to_string(maxVal.first) + 'U';
+        }
+    }
+
+    return "static_cast<std::size_t>(std::numeric_limits<" + cppType + ">::max())";
+}
+
+} // namespace
+
+const std::string& endianStr(const DB& db)
+{
+    static const std::string BigStr("comms::traits::endian::Big");
+    static const std::string LittleStr("comms::traits::endian::Little");
+    if (ba::contains(db.getEndian(), "Big")) {
+        return BigStr;
+    }
+
+    return LittleStr;
+}
+
+std::string accessorName(const std::string& name)
+{
+    return "field_" + name;
+}
+
+std::string elementName(const Field& group)
+{
+    return group.getName() + common::elementSuffixStr();
+}
+
+std::string offsetStr(unsigned offset)
+{
+    return std::to_string(offset) + 'U';
+}
+
+const std::string& cppTypeFor(const std::string& primType)
+{
+    static const std::string FloatStr("float");
+    static const std::string DoubleStr("double");
+    if (primType == FloatStr) {
+        return FloatStr;
+    }
+
+    if (primType == DoubleStr) {
+        return DoubleStr;
+    }
+
+    return common::primitiveTypeToStdInt(primType);
+}
+
+// Constant fields are not serialised, the same way as in the message class.
+unsigned wireLength(const Field& field)
+{
+    assert(field.getKind() == Field::Kind::Basic);
+    if (field.isConstant()) {
+        return 0U;
+    }
+
+    return static_cast<const BasicField&>(field).getSerializationLength();
+}
+
+unsigned rootLength(const FieldsList& fields)
+{
+    unsigned result = 0U;
+    for (auto& f : fields) {
+        if (f->getKind() != Field::Kind::Basic) {
+            break;
+        }
+        result += wireLength(*f);
+    }
+    return result;
+}
+
+unsigned minRootLength(const FieldsList& fields, unsigned baseVersion)
+{
+    unsigned offset = 0U;
+    unsigned result = 0U;
+    for (auto& f : fields) {
+        if (f->getKind() != Field::Kind::Basic) {
+            break;
+        }
+
+        offset += wireLength(*f);
+        if (f->getSinceVersion() <= baseVersion) {
+            result = offset;
+        }
+    }
+    return result;
+}
+
+bool hasNonBasic(const FieldsList& fields)
+{
+    return std::any_of(
+        fields.begin(), fields.end(),
+        [](const FieldPtr& f)
+        {
+            return f->getKind() != Field::Kind::Basic;
+        });
+}
+
+std::string dataLengthType(const Field& field)
+{
+    assert(field.getKind() == Field::Kind::Data);
+    auto* type = static_cast<const DataField&>(field).getReferencedType();
+    assert(type != nullptr);
+    auto& members = asCompositeType(*type->getRealType()).getMembers();
+    assert(!members.empty());
+    auto* lenType = members.front()->getRealType();
+    assert(lenType->getKind() == Type::Kind::Basic);
+    return cppTypeFor(asBasicType(*lenType).getPrimitiveType());
+}
+
+std::string dataMaxLength(const Field& field)
+{
+    assert(field.getKind() == Field::Kind::Data);
+    auto* type = static_cast<const DataField&>(field).getReferencedType();
+    assert(type != nullptr);
+    auto& members = asCompositeType(*type->getRealType()).getMembers();
+    assert(!members.empty());
+    auto* lenType = members.front()->getRealType();
+    return maxCountStr(*lenType, dataLengthType(field));
+}
+
+Dimension dimensionOf(const GroupField& group)
+{
+    auto* dimType = group.getReferencedDimensionType();
+    assert(dimType != nullptr);
+    auto& dimComp = asCompositeType(*dimType->getRealType());
+    Dimension result;
+    for (auto& m : dimComp.getMembers()) {
+        auto* realMem = m->getRealType();
+        assert(realMem->getKind() == Type::Kind::Basic);
+        auto& memType = cppTypeFor(asBasicType(*realMem).getPrimitiveType());
+        if (m->getName() == common::blockLengthStr()) {
+            result.m_blockLengthType = memType;
+            result.m_blockLengthOffset = result.m_length;
+        }
+        else if (m->getName() == common::numInGroupStr()) {
+            result.m_numInGroupType = memType;
+            result.m_maxNumInGroup = maxCountStr(*realMem, memType);
+            result.m_numInGroupOffset = result.m_length;
+        }
+        result.m_length += static_cast<unsigned>(m->getSerializationLength());
+    }
+    assert(!result.m_blockLengthType.empty());
+    assert(!result.m_numInGroupType.empty());
+    return result;
+}
+
+bool forEachLeaf(
+    const DB& db,
+    Headers& headers,
+    const std::string& className,
+    const std::string& name,
+    const Type& type,
+    unsigned offset,
+    const LeafFunc& func)
+{
+    auto* realType = type.getRealType();
+    assert(realType != nullptr);
+    if (type.isConstant() || realType->isConstant()) {
+        return true;
+    }
+
+    Leaf leaf;
+    leaf.m_name = name;
+    leaf.m_offset = offset;
+    auto kind = realType->getKind();
+    if (kind == Type::Kind::Basic) {
+        auto& basicType = asBasicType(*realType);
+        auto& cppType = cppTypeFor(basicType.getPrimitiveType());
+        auto count = basicType.getLengthProp();
+        if (cppType.empty() || (count == 0U)) {
+            log::warning() << "Unsupported type of \"" << name << "\" field, skipping it in \"" << className << "\"." << std::endl;
+            return false;
+        }
+
+        leaf.m_valueType = cppType;
+        leaf.m_rawType = cppType;
+        leaf.m_count = count;
+        leaf.m_elemLen = static_cast<unsigned>(basicType.getSerializationLength() / count);
+        func(leaf);
+        return true;
+    }
+
+    if (kind == Type::Kind::Enum) {
+        auto& rawType = static_cast<const EnumType&>(*realType).getUnderlyingType();
+        if (rawType.empty()) {
+            log::warning() << "Unsupported underlying type of \"" << name << "\" enum, skipping it in \"" << className << "\"." << std::endl;
+            return false;
+        }
+
+        leaf.m_valueType = rawType;
+        leaf.m_rawType = rawType;
+        auto& typeName = realType->getName();
+        if (db.findType(typeName) == realType) {
+            leaf.m_valueType = common::fieldNamespaceStr() + typeName + common::enumValSuffixStr();
+            headers.insert(common::localHeader(db.getProtocolNamespace(), common::fieldNamespaceNameStr(), typeName + ".h"));
+        }
+
+        leaf.m_elemLen = static_cast<unsigned>(realType->getSerializationLength());
+        func(leaf);
+        return true;
+    }
+
+    if (kind == Type::Kind::Set) {
+        auto len = realType->getSerializationLength();
+        auto& rawType = unsignedTypeFor(len);
+        if (rawType.empty()) {
+            log::warning() << "Unsupported length of \"" << name << "\" set, skipping it in \"" << className << "\"." << std::endl;
+            return false;
+        }
+
+        leaf.m_valueType = rawType;
+        leaf.m_rawType = rawType;
+        leaf.m_elemLen = static_cast<unsigned>(len);
+        func(leaf);
+        return true;
+    }
+
+    assert(kind == Type::Kind::Composite);
+    bool result = true;
+    auto memOffset = offset;
+    for (auto& m : asCompositeType(*realType).getMembers()) {
+        auto& memName = m->getName();
+        if ((!isPaddingMember(memName)) &&
+            (!forEachLeaf(db, headers, className, name + '_' + memName, *m, memOffset, func))) {
+            result = false;
+        }
+
+        memOffset += static_cast<unsigned>(m->getSerializationLength());
+    }
+    return result;
+}
+
+} // namespace flyweight
+
+} // namespace sbe2comms
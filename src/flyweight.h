@@ -0,0 +1,87 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <set>
+#include <vector>
+#include <functional>
+
+#include "Field.h"
+
+namespace sbe2comms
+{
+
+class DB;
+class Type;
+class GroupField;
+
+namespace flyweight
+{
+
+using FieldsList = std::vector<FieldPtr>;
+using Headers = std::set<std::string>;
+
+/// \brief Single value serialised at fixed offset of the block.
+struct Leaf
+{
+    std::string m_name;
+    std::string m_valueType;
+    std::string m_rawType;
+    unsigned m_offset = 0U;
+    unsigned m_count = 1U;
+    unsigned m_elemLen = 0U;
+};
+
+/// \brief Layout of the "group" dimension type.
+struct Dimension
+{
+    std::string m_blockLengthType;
+    std::string m_numInGroupType;
+    std::string m_maxNumInGroup;
+    unsigned m_blockLengthOffset = 0U;
+    unsigned m_numInGroupOffset = 0U;
+    unsigned m_length = 0U;
+};
+
+using LeafFunc = std::function<void (const Leaf&)>;
+
+const std::string& endianStr(const DB& db);
+std::string accessorName(const std::string& name);
+std::string elementName(const Field& group);
+std::string offsetStr(unsigned offset);
+const std::string& cppTypeFor(const std::string& primType);
+unsigned wireLength(const Field& field);
+unsigned rootLength(const FieldsList& fields);
+unsigned minRootLength(const FieldsList& fields, unsigned baseVersion);
+bool hasNonBasic(const FieldsList& fields);
+std::string dataLengthType(const Field& field);
+std::string dataMaxLength(const Field& field);
+Dimension dimensionOf(const GroupField& group);
+bool forEachLeaf(
+    const DB& db,
+    Headers& headers,
+    const std::string& className,
+    const std::string& name,
+    const Type& type,
+    unsigned offset,
+    const LeafFunc& func);
+
+} // namespace flyweight
+
+} // namespace sbe2comms
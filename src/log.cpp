@@ -25,22 +25,79 @@ namespace sbe2comms
 namespace log
 {
 
-std::ostream& error()
+namespace
+{
+
+thread_local std::ostream* OutRedirect = nullptr;
+thread_local std::ostream* ErrRedirect = nullptr;
+
+std::ostream& outStream()
 {
-    std::cerr << "ERROR: ";
+    if (OutRedirect != nullptr) {
+        return *OutRedirect;
+    }
+    return std::cout;
+}
+
+std::ostream& errStream()
+{
+    if (ErrRedirect != nullptr) {
+        return *ErrRedirect;
+    }
     return std::cerr;
 }
 
+} // namespace
+
+std::ostream& error()
+{
+    auto& out = errStream();
+    out << "ERROR: ";
+    return out;
+}
+
 std::ostream& warning()
 {
-    std::cerr << "WARNING: ";
-    return std::cerr;
+    auto& out = errStream();
+    out << "WARNING: ";
+    return out;
 }
 
 std::ostream& info()
 {
-    std::cout << "INFO: ";
-    return std::cout;
+    auto& out = outStream();
+    out << "INFO: ";
+    return out;
+}
+
+void Buffer::flush()
+{
+    auto outStr = m_out.str();
+    if (!outStr.empty()) {
+        std::cout << outStr << std::flush;
+    }
+
+    auto errStr = m_err.str();
+    if (!errStr.empty()) {
+        std::cerr << errStr << std::flush;
+    }
+
+    m_out.str(std::string());
+    m_err.str(std::string());
+}
+
+Redirect::Redirect(Buffer& buf)
+  : m_prevOut(OutRedirect),
+    m_prevErr(ErrRedirect)
+{
+    OutRedirect = &buf.m_out;
+    ErrRedirect = &buf.m_err;
+}
+
+Redirect::~Redirect() noexcept
+{
+    OutRedirect = m_prevOut;
+    ErrRedirect = m_prevErr;
 }
 
 } // namespace log
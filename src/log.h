@@ -18,6 +18,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <sstream>
 
 namespace sbe2comms
 {
@@ -31,6 +32,37 @@ std::ostream& warning();
 
 std::ostream& info();
 
+/// \brief Storage for the log output captured by \ref Redirect.
+/// \details Used when the code generation is distributed between multiple
+///     threads. The captured output is replayed with flush() in the
+///     order chosen by the caller, which keeps the log deterministic.
+class Buffer
+{
+public:
+    void flush();
+
+private:
+    friend class Redirect;
+
+    std::ostringstream m_out;
+    std::ostringstream m_err;
+};
+
+/// \brief Redirects all the log output of the current thread into the
+///     provided \ref Buffer for the lifetime of the object.
+class Redirect
+{
+public:
+    explicit Redirect(Buffer& buf);
+    ~Redirect() noexcept;
+
+    Redirect(const Redirect&) = delete;
+    Redirect& operator=(const Redirect&) = delete;
+
+private:
+    std::ostream* m_prevOut = nullptr;
+    std::ostream* m_prevErr = nullptr;
+};
 
 } // namespace log
 
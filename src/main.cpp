@@ -16,210 +16,65 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
-#include <fstream>
+#include <chrono>
 
-#include <boost/filesystem.hpp>
-
-#include "DB.h"
 #include "ProgramOptions.h"
-#include "BuiltIn.h"
-#include "MsgId.h"
-#include "MsgInterface.h"
-#include "AllMessages.h"
-#include "AllFields.h"
-#include "MessageHeaderLayer.h"
-#include "OpenFramingHeaderLayer.h"
-#include "TransportFrame.h"
-#include "FieldBase.h"
-#include "common.h"
-#include "output.h"
+#include "Generator.h"
+#include "FilesystemSink.h"
+#include "Watcher.h"
 #include "log.h"
-#include "Cmake.h"
-#include "TransportMessage.h"
-#include "Protocol.h"
-#include "Plugin.h"
-#include "Doxygen.h"
-#include "MessageSchema.h"
-
-namespace bf = boost::filesystem;
+#include "stats.h"
 
 namespace sbe2comms
 {
 
-bool writeMessageSchema(DB& db)
-{
-    return MessageSchema::write(db);
-}
-
-bool writeBuiltIn(DB& db)
-{
-    BuiltIn obj(db);
-    return obj.write();
-}
-
-bool writeMessages(DB& db)
+bool reportStats(const ProgramOptions& options)
 {
-    auto& messages = db.getMessages();
-    for (auto iter = messages.begin(); iter != messages.end(); ++iter) {
-        assert(iter->second);
-        if (!iter->second->write()) {
-            return false;
-        }
+    if (options.statsRequested()) {
+        stats::printSummary();
     }
-    return true;
-}
 
-bool writeTypes(DB& db)
-{
-    FieldBase fieldBase(db);
-    bool result = fieldBase.write();
-    for (auto& t : db.getTypes()) {
-        assert(t.second);
-        result = t.second->writeProtocolDef() && result;
+    if (options.hasTraceFile()) {
+        return stats::writeTrace(options.getTraceFile());
     }
 
-    AllFields allFields(db);
-    result = allFields.write() && result;
-    return result;
+    return true;
 }
 
-bool writeDefaultOptions(DB& db)
+bool watch(const ProgramOptions& options, Generator& generator)
 {
-    if (!common::createProtocolDefDir(db.getRootPath(), db.getProtocolNamespace())) {
-        return false;
-    }
-
-    auto fileRelPath = common::protocolDirRelPath(db.getProtocolNamespace(), common::defaultOptionsFileName());
-    log::info() << "Generating " << fileRelPath << std::endl;
-
-    auto filePath = (bf::path(db.getRootPath()) / fileRelPath).string();
-
-    std::ofstream stream(filePath);
-    if (!stream) {
-        log::error() << "Failed to create " << filePath << std::endl;
-        return false;
-    }
-
-    auto& ns = db.getProtocolNamespace();
-    stream << "/// \\file\n"
-              "/// \\brief Contains definition of \\ref " << common::scopeFor(ns, common::defaultOptionsStr()) << " default options class.\n"
-              "\n\n"
-              "#pragma once\n\n"
-              "#include \"comms/options.h\"\n\n";
-
-    if (!ns.empty()) {
-        stream << "namespace " << ns << "\n"
-                  "{\n\n";
-    }
-
-    stream << "/// \\brief Default options for the protocol.\n"
-              "/// \\details Defines \\b comms::option::EmptyOption to be extra option\n"
-              "///     of every defined field. To customize the protocol options, just\n"
-              "///     inherith from this struct and redefine relevant types.\n"
-              "/// \\headerfile " << common::localHeader(ns, common::defaultOptionsFileName()) << "\n"
-              "struct " << common::defaultOptionsStr() << "\n"
-              "{\n" <<
-              output::indent(1) << "/// \\brief Scope for the options relevant to fields from\n" <<
-              output::indent(1) << "///     " << common::scopeFor(ns, common::fieldNamespaceNameStr()) << " namespace.\n" <<
-              output::indent(1) << "struct " << common::fieldNamespaceNameStr() << '\n' <<
-              output::indent(1) << "{\n";
-
-    bool result = true;
-    auto fieldsScope = common::scopeFor(ns, common::fieldNamespaceStr());
-    for (auto& t : db.getTypes()) {
-        result = t.second->writeDefaultOptions(stream, 2, fieldsScope) && result;
+    Watcher watcher;
+    for (auto& f : options.getFiles()) {
+        if (!watcher.watch(f)) {
+            return false;
+        }
     }
 
-    stream << output::indent(1) << "}; // " << common::fieldNamespaceNameStr() << "\n\n" <<
-              output::indent(1) << "/// \\brief Scope for all the options relevant to messages' fields.\n" <<
-              output::indent(1) << "struct " << common::messageNamespaceNameStr() << '\n' <<
-              output::indent(1) << "{\n";
-
-    auto messagesScope = common::scopeFor(ns, common::messageNamespaceStr());
-    for (auto& m : db.getMessages()) {
-        assert(m.second);
-        result = m.second->writeDefaultOptions(stream, 2, messagesScope) && result;
-    }
+    while (true) {
+        auto startTime = std::chrono::steady_clock::now();
+        bool result = generator.generate();
+        for (auto& f : generator.getIncludedFiles()) {
+            result = watcher.watch(f) && result;
+        }
 
-    stream << output::indent(1) << "}; // " << common::messageNamespaceNameStr() << "\n\n" <<
-              "}; // DefaultOptions\n\n";
+        // Every regeneration is reported on its own
+        result = reportStats(options) && result;
+        stats::reset();
 
-    if (!ns.empty()) {
-        stream << "} // namespace " << ns << "\n\n";
-    }
+        auto duration = std::chrono::steady_clock::now() - startTime;
+        auto durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+        if (result) {
+            log::info() << "Regenerated in " << durationMs << " ms" << std::endl;
+        }
+        else {
+            log::error() << "Regeneration failed after " << durationMs << " ms" << std::endl;
+        }
 
-    if (!stream.good()) {
-        log::error() << "The file " << fileRelPath << "hasn't been written properly!" << std::endl;
-        return false;
+        log::info() << "Waiting for the schema modifications..." << std::endl;
+        if (!watcher.waitForChange()) {
+            return false;
+        }
     }
-
-    return result;
-}
-
-bool writeMsgId(DB& db)
-{
-    MsgId msgId(db);
-    return msgId.write();
-}
-
-bool writeMsgInterface(DB& db)
-{
-    MsgInterface msgInterface(db);
-    return msgInterface.write();
-}
-
-bool writeAllMessages(DB& db)
-{
-    AllMessages obj(db);
-    return obj.write();
-}
-
-bool writeMessageHeaderLayer(DB& db)
-{
-    MessageHeaderLayer obj(db);
-    return obj.write();
-}
-
-bool writeOpenFramingHeaderLayer(DB& db)
-{
-    OpenFramingHeaderLayer obj(db);
-    return obj.write();
-}
-
-bool writeTransportFrame(DB& db)
-{
-    TransportFrame obj(db);
-    return obj.write();
-}
-
-bool writeTransportMessage(DB& db)
-{
-    TransportMessage obj(db);
-    return obj.write();
-}
-
-bool writeProtocol(DB& db)
-{
-    Protocol obj(db);
-    return obj.write();
-}
-
-bool writePlugin(DB& db)
-{
-    Plugin obj(db);
-    return obj.write();
-}
-
-bool writeCmake(DB& db)
-{
-    Cmake obj(db);
-    return obj.write();
-}
-
-bool writeDoxygen(DB& db)
-{
-    Doxygen obj(db);
-    return obj.write();
 }
 
 } // namespace sbe2comms
@@ -229,31 +84,27 @@ int main(int argc, const char* argv[])
     sbe2comms::ProgramOptions options;
     options.parse(argc, argv);
     if (options.helpRequested()) {
-        std::cout << "Usage:\n\t" << argv[0] << " [OPTIONS] schema_file\n";
+        std::cout << "Usage:\n\t" << argv[0] << " [OPTIONS] schema_file [schema_file...]\n";
         options.printHelp(std::cout);
         return 0;
     }
 
-    sbe2comms::DB db;
-    bool result =
-        db.parseSchema(options) &&
-        sbe2comms::writeMessageSchema(db) &&
-        sbe2comms::writeBuiltIn(db) &&
-        sbe2comms::writeMessages(db) &&
-        sbe2comms::writeTypes(db) &&
-        sbe2comms::writeDefaultOptions(db) &&
-        sbe2comms::writeMsgId(db) &&
-        sbe2comms::writeMsgInterface(db) &&
-        sbe2comms::writeAllMessages(db) &&
-        sbe2comms::writeMessageHeaderLayer(db) &&
-        sbe2comms::writeOpenFramingHeaderLayer(db) &&
-        sbe2comms::writeTransportFrame(db) &&
-        sbe2comms::writeTransportMessage(db) &&
-        sbe2comms::writeProtocol(db) &&
-        sbe2comms::writePlugin(db) &&
-        sbe2comms::writeCmake(db) &&
-        sbe2comms::writeDoxygen(db)
-    ;
+    if (options.statsRequested() || options.hasTraceFile()) {
+        sbe2comms::stats::enable();
+    }
+
+    sbe2comms::FilesystemSink sink(options.getOutputDirectory());
+    sbe2comms::Generator generator(options, sink);
+    for (auto& f : options.getFiles()) {
+        generator.addFile(f);
+    }
+
+    if (options.watchRequested()) {
+        return sbe2comms::watch(options, generator) ? 0 : -1;
+    }
+
+    bool result = generator.generate();
+    result = sbe2comms::reportStats(options) && result;
 
     if (result) {
         std::cout << "SUCCESS" << std::endl;
@@ -262,3 +113,4 @@ int main(int argc, const char* argv[])
 
     return -1;
 }
+
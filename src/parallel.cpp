@@ -0,0 +1,100 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "parallel.h"
+
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+
+#include "log.h"
+#include "stats.h"
+
+namespace sbe2comms
+{
+
+namespace parallel
+{
+
+unsigned jobsCount(unsigned requested)
+{
+    if (requested != 0U) {
+        return requested;
+    }
+
+    return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+bool run(const TasksList& tasks, unsigned jobs)
+{
+    jobs = std::min(jobsCount(jobs), static_cast<unsigned>(tasks.size()));
+    if (jobs <= 1U) {
+        bool result = true;
+        for (auto& t : tasks) {
+            assert(t);
+            result = t() && result;
+        }
+        return result;
+    }
+
+    std::unique_ptr<log::Buffer[]> logs(new log::Buffer[tasks.size()]);
+    std::unique_ptr<bool[]> results(new bool[tasks.size()]);
+    std::atomic<std::size_t> nextTask(0U);
+    auto phaseDepth = stats::phaseDepth();
+
+    auto workerFunc =
+        [&tasks, &logs, &results, &nextTask, phaseDepth]()
+        {
+            stats::setPhaseDepth(phaseDepth);
+            while (true) {
+                auto idx = nextTask++;
+                if (tasks.size() <= idx) {
+                    break;
+                }
+
+                log::Redirect redirect(logs[idx]);
+                results[idx] = tasks[idx]();
+            }
+        };
+
+    std::vector<std::thread> workers;
+    workers.reserve(jobs - 1U);
+    for (auto idx = 1U; idx < jobs; ++idx) {
+        workers.emplace_back(workerFunc);
+    }
+
+    workerFunc();
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // Replay the log the same way the sequential execution would have
+    // produced it: in the tasks order, including all the failures.
+    bool result = true;
+    for (auto idx = 0U; idx < tasks.size(); ++idx) {
+        logs[idx].flush();
+        result = results[idx] && result;
+    }
+
+    return result;
+}
+
+} // namespace parallel
+
+} // namespace sbe2comms
@@ -54,10 +54,11 @@ const std::string ValueRef("valueRef");
 const std::string DimensionType("dimensionType");
 const std::string GroupSizeEncoding("groupSizeEncoding");
 const std::string Id("id");
+const std::string Package("package");
 
 const std::string& getProp(
     const XmlPropsMap& map,
-    const std::string propName,
+    const std::string& propName,
     const std::string& defValue = EmptyStr)
 {
     auto iter = map.find(propName);
@@ -68,7 +69,7 @@ const std::string& getProp(
     return iter->second;
 }
 
-bool hasProp(const XmlPropsMap& map, const std::string propName)
+bool hasProp(const XmlPropsMap& map, const std::string& propName)
 {
     return map.find(propName) != map.end();
 }
@@ -76,11 +77,15 @@ bool hasProp(const XmlPropsMap& map, const std::string propName)
 template <typename T>
 T getPropInt(
     const XmlPropsMap& map,
-    const std::string propName,
+    const std::string& propName,
     const T& defValue = T())
 {
+    auto& strVal = getProp(map, propName);
+    if (strVal.empty()) {
+        return defValue;
+    }
+
     try {
-        auto strVal = getProp(map, propName);
         return static_cast<T>(std::stoll(strVal));
     }
     catch (...) {
@@ -239,6 +244,11 @@ unsigned id(const XmlPropsMap& map)
     return getPropInt<unsigned>(map, Id);
 }
 
+const std::string& package(const XmlPropsMap& map)
+{
+    return getProp(map, Package);
+}
+
 } // namespace prop
 
 } // namespace sbe2comms
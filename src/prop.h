@@ -54,6 +54,7 @@ const std::string& characterEncoding(const XmlPropsMap& map);
 const std::string& valueRef(const XmlPropsMap& map);
 const std::string& dimensionType(const XmlPropsMap& map);
 unsigned id(const XmlPropsMap& map);
+const std::string& package(const XmlPropsMap& map);
 
 } // namespace prop
 
@@ -0,0 +1,468 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stats.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include <libxml/xmlmemory.h>
+
+#include "log.h"
+
+namespace sbe2comms
+{
+
+namespace stats
+{
+
+namespace
+{
+
+struct Counters
+{
+    std::uint64_t m_allocs;
+    std::uint64_t m_allocBytes;
+    std::uint64_t m_generatedBytes;
+    std::uint64_t m_writtenBytes;
+};
+
+struct Event
+{
+    Kind m_kind;
+    std::string m_name;
+    double m_startUs;
+    double m_durationUs;
+    unsigned m_thread;
+    unsigned m_depth;
+    Counters m_counters;
+    std::uint64_t m_peakMemoryKb;
+};
+
+struct Total
+{
+    unsigned m_count;
+    double m_durationUs;
+    Counters m_counters;
+};
+
+using Clock = std::chrono::steady_clock;
+
+bool Enabled = false;
+Clock::time_point StartTime;
+
+std::atomic<std::uint64_t> TotalAllocs(0U);
+std::atomic<std::uint64_t> TotalAllocBytes(0U);
+std::atomic<std::uint64_t> TotalGeneratedBytes(0U);
+std::atomic<std::uint64_t> TotalWrittenBytes(0U);
+thread_local Counters ThreadCounters;
+thread_local unsigned PhaseDepth = 0U;
+
+std::mutex EventsLock;
+std::vector<Event> Events;
+std::map<std::thread::id, unsigned> Threads;
+
+// Phases span the work distributed between threads, while messages, types
+// and other components are always written by a single thread.
+Counters countersFor(Kind kind)
+{
+    if (kind == Kind::Phase) {
+        return Counters {
+            TotalAllocs.load(std::memory_order_relaxed),
+            TotalAllocBytes.load(std::memory_order_relaxed),
+            TotalGeneratedBytes.load(std::memory_order_relaxed),
+            TotalWrittenBytes.load(std::memory_order_relaxed)
+        };
+    }
+
+    return ThreadCounters;
+}
+
+const char* kindName(Kind kind)
+{
+    static const char* Names[] = {
+        "phase",
+        "component",
+        "message",
+        "type"
+    };
+
+    auto idx = static_cast<unsigned>(kind);
+    if (std::extent<decltype(Names)>::value <= idx) {
+        return "unknown";
+    }
+
+    return Names[idx];
+}
+
+// Peak resident memory of the process so far
+std::uint64_t peakMemoryKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0) {
+        return 0U;
+    }
+    return static_cast<std::uint64_t>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0U;
+    }
+#ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss / 1024);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+std::string toKb(std::uint64_t bytes)
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1) << (static_cast<double>(bytes) / 1024);
+    return stream.str();
+}
+
+void printRow(
+    const std::string& name,
+    const std::string& time,
+    const std::string& allocs,
+    const std::string& allocKb,
+    const std::string& genKb,
+    const std::string& writtenKb,
+    const std::string& peakMb)
+{
+    log::info() << std::left << std::setw(40) << name << std::right <<
+        std::setw(12) << time <<
+        std::setw(12) << allocs <<
+        std::setw(14) << allocKb <<
+        std::setw(14) << genKb <<
+        std::setw(14) << writtenKb <<
+        std::setw(12) << peakMb << std::endl;
+}
+
+void printEvent(
+    const std::string& name,
+    double durationUs,
+    const Counters& counters,
+    const std::string& peakMb = std::string())
+{
+    std::ostringstream time;
+    time << std::fixed << std::setprecision(2) << (durationUs / 1000);
+    printRow(
+        name,
+        time.str(),
+        std::to_string(counters.m_allocs),
+        toKb(counters.m_allocBytes),
+        toKb(counters.m_generatedBytes),
+        toKb(counters.m_writtenBytes),
+        peakMb);
+}
+
+void printHeader(const std::string& title)
+{
+    printRow(title, "Time (ms)", "Allocs", "Alloc (KB)", "Output (KB)", "Written (KB)", "Peak (MB)");
+}
+
+std::string jsonEscape(const std::string& str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (auto ch : str) {
+        if ((ch == '"') || (ch == '\\')) {
+            result += '\\';
+        }
+        result += ch;
+    }
+    return result;
+}
+
+void* xmlMallocCounted(std::size_t size)
+{
+    recordAllocation(size);
+    return std::malloc(size);
+}
+
+void* xmlReallocCounted(void* ptr, std::size_t size)
+{
+    recordAllocation(size);
+    return std::realloc(ptr, size);
+}
+
+char* xmlStrdupCounted(const char* str)
+{
+    auto len = std::strlen(str) + 1;
+    recordAllocation(len);
+    auto* result = static_cast<char*>(std::malloc(len));
+    if (result != nullptr) {
+        std::memcpy(result, str, len);
+    }
+    return result;
+}
+
+void xmlFreeCounted(void* ptr)
+{
+    std::free(ptr);
+}
+
+} // namespace
+
+Scope::Scope(Kind kind, const std::string& name)
+  : m_active(Enabled),
+    m_kind(kind)
+{
+    if (!m_active) {
+        return;
+    }
+
+    m_name = name;
+    if (m_kind == Kind::Phase) {
+        m_depth = PhaseDepth;
+        ++PhaseDepth;
+    }
+
+    auto counters = countersFor(m_kind);
+    m_allocs = counters.m_allocs;
+    m_allocBytes = counters.m_allocBytes;
+    m_generatedBytes = counters.m_generatedBytes;
+    m_writtenBytes = counters.m_writtenBytes;
+    m_start = Clock::now();
+}
+
+Scope::~Scope() noexcept
+{
+    if (!m_active) {
+        return;
+    }
+
+    auto end = Clock::now();
+    auto counters = countersFor(m_kind);
+    if (m_kind == Kind::Phase) {
+        --PhaseDepth;
+    }
+
+    using Micro = std::chrono::duration<double, std::micro>;
+    Event event {
+        m_kind,
+        std::move(m_name),
+        std::chrono::duration_cast<Micro>(m_start - StartTime).count(),
+        std::chrono::duration_cast<Micro>(end - m_start).count(),
+        0U,
+        m_depth,
+        Counters {
+            counters.m_allocs - m_allocs,
+            counters.m_allocBytes - m_allocBytes,
+            counters.m_generatedBytes - m_generatedBytes,
+            counters.m_writtenBytes - m_writtenBytes
+        },
+        peakMemoryKb()
+    };
+
+    try {
+        std::lock_guard<std::mutex> guard(EventsLock);
+        auto threadIter = Threads.insert(std::make_pair(std::this_thread::get_id(), static_cast<unsigned>(Threads.size()))).first;
+        event.m_thread = threadIter->second;
+        Events.push_back(std::move(event));
+    }
+    catch (...) {
+        // Dropping the event is preferable to terminating the generation.
+    }
+}
+
+void enable()
+{
+    // Account for the schema parsing as well
+    xmlMemSetup(&xmlFreeCounted, &xmlMallocCounted, &xmlReallocCounted, &xmlStrdupCounted);
+    StartTime = Clock::now();
+    Enabled = true;
+}
+
+bool isEnabled()
+{
+    return Enabled;
+}
+
+void reset()
+{
+    std::lock_guard<std::mutex> guard(EventsLock);
+    Events.clear();
+    StartTime = Clock::now();
+}
+
+unsigned phaseDepth()
+{
+    return PhaseDepth;
+}
+
+// Phases started by the worker threads are nested in the phase
+// of the thread, which distributed the work.
+void setPhaseDepth(unsigned depth)
+{
+    PhaseDepth = depth;
+}
+
+void recordAllocation(std::size_t size)
+{
+    if (!Enabled) {
+        return;
+    }
+
+    ++ThreadCounters.m_allocs;
+    ThreadCounters.m_allocBytes += size;
+    TotalAllocs.fetch_add(1U, std::memory_order_relaxed);
+    TotalAllocBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void recordOutput(std::size_t generated, std::size_t written)
+{
+    if (!Enabled) {
+        return;
+    }
+
+    ThreadCounters.m_generatedBytes += generated;
+    ThreadCounters.m_writtenBytes += written;
+    TotalGeneratedBytes.fetch_add(generated, std::memory_order_relaxed);
+    TotalWrittenBytes.fetch_add(written, std::memory_order_relaxed);
+}
+
+void printSummary()
+{
+    static const std::size_t MaxElements = 10U;
+
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> guard(EventsLock);
+        events = Events;
+    }
+
+    std::stable_sort(
+        events.begin(), events.end(),
+        [](const Event& e1, const Event& e2)
+        {
+            return e1.m_startUs < e2.m_startUs;
+        });
+
+    printHeader("Phase");
+    std::map<Kind, Total> totals;
+    std::vector<const Event*> elements;
+    for (auto& e : events) {
+        if (e.m_kind == Kind::Phase) {
+            std::ostringstream peak;
+            peak << std::fixed << std::setprecision(1) << (static_cast<double>(e.m_peakMemoryKb) / 1024);
+            printEvent(std::string(e.m_depth * 2, ' ') + e.m_name, e.m_durationUs, e.m_counters, peak.str());
+            continue;
+        }
+
+        auto& total = totals[e.m_kind];
+        ++total.m_count;
+        total.m_durationUs += e.m_durationUs;
+        total.m_counters.m_allocs += e.m_counters.m_allocs;
+        total.m_counters.m_allocBytes += e.m_counters.m_allocBytes;
+        total.m_counters.m_generatedBytes += e.m_counters.m_generatedBytes;
+        total.m_counters.m_writtenBytes += e.m_counters.m_writtenBytes;
+        elements.push_back(&e);
+    }
+
+    if (elements.empty()) {
+        return;
+    }
+
+    printHeader("Kind");
+    for (auto& t : totals) {
+        auto name = std::string(kindName(t.first)) + " (" + std::to_string(t.second.m_count) + ')';
+        printEvent(name, t.second.m_durationUs, t.second.m_counters);
+    }
+
+    std::stable_sort(
+        elements.begin(), elements.end(),
+        [](const Event* e1, const Event* e2)
+        {
+            return e2->m_durationUs < e1->m_durationUs;
+        });
+
+    if (MaxElements < elements.size()) {
+        elements.resize(MaxElements);
+    }
+
+    printHeader("Slowest");
+    for (auto* e : elements) {
+        printEvent(e->m_name, e->m_durationUs, e->m_counters);
+    }
+}
+
+bool writeTrace(const std::string& filePath)
+{
+    std::ofstream stream(filePath);
+    if (!stream) {
+        log::error() << "Failed to create " << filePath << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(EventsLock);
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+    for (auto& e : Events) {
+        if (!first) {
+            stream << ',';
+        }
+        first = false;
+
+        stream << std::fixed << std::setprecision(3) <<
+            "\n{\"name\":\"" << jsonEscape(e.m_name) << "\",\"cat\":\"" << kindName(e.m_kind) <<
+            "\",\"ph\":\"X\",\"ts\":" << e.m_startUs << ",\"dur\":" << e.m_durationUs <<
+            ",\"pid\":1,\"tid\":" << e.m_thread <<
+            ",\"args\":{\"allocs\":" << e.m_counters.m_allocs <<
+            ",\"allocBytes\":" << e.m_counters.m_allocBytes <<
+            ",\"outputBytes\":" << e.m_counters.m_generatedBytes <<
+            ",\"writtenBytes\":" << e.m_counters.m_writtenBytes <<
+            ",\"peakMemoryKb\":" << e.m_peakMemoryKb << "}}";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    stream.flush();
+
+    if (!stream.good()) {
+        log::error() << "The file " << filePath << " hasn't been written properly!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace stats
+
+} // namespace sbe2comms
@@ -0,0 +1,75 @@
+//
+// Copyright 2017 (C). Alex Robenko. All rights reserved.
+//
+
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace sbe2comms
+{
+
+namespace stats
+{
+
+enum class Kind
+{
+    Phase,
+    Component,
+    Message,
+    Type
+};
+
+class Scope
+{
+public:
+    Scope(Kind kind, const std::string& name);
+    ~Scope() noexcept;
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool m_active = false;
+    Kind m_kind = Kind::Phase;
+    std::string m_name;
+    Clock::time_point m_start;
+    unsigned m_depth = 0U;
+    std::uint64_t m_allocs = 0U;
+    std::uint64_t m_allocBytes = 0U;
+    std::uint64_t m_generatedBytes = 0U;
+    std::uint64_t m_writtenBytes = 0U;
+};
+
+void enable();
+bool isEnabled();
+void reset();
+unsigned phaseDepth();
+void setPhaseDepth(unsigned depth);
+void recordAllocation(std::size_t size);
+void recordOutput(std::size_t generated, std::size_t written);
+void printSummary();
+bool writeTrace(const std::string& filePath);
+
+} // namespace stats
+
+} // namespace sbe2comms
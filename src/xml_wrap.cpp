@@ -18,22 +18,102 @@
 #include "xml_wrap.h"
 
 #include <cassert>
+#include <cstring>
 #include <string>
+#include <algorithm>
 
 namespace sbe2comms
 {
 
+XmlPropsMap::const_iterator XmlPropsMap::find(const std::string& name) const
+{
+    auto iter =
+        std::lower_bound(
+            m_props.begin(), m_props.end(), name,
+            [](const value_type& prop, const std::string& n)
+            {
+                return prop.first < n;
+            });
+
+    if ((iter == m_props.end()) || (iter->first != name)) {
+        return m_props.end();
+    }
+
+    return iter;
+}
+
+void XmlPropsMap::insert(std::string name, std::string value)
+{
+    auto iter =
+        std::lower_bound(
+            m_props.begin(), m_props.end(), name,
+            [](const value_type& prop, const std::string& n)
+            {
+                return prop.first < n;
+            });
+
+    if ((iter != m_props.end()) && (iter->first == name)) {
+        return;
+    }
+
+    m_props.emplace(iter, std::move(name), std::move(value));
+}
+
+XmlChildren::Iterator::Iterator(xmlNodePtr node, const char* name)
+  : m_node(node),
+    m_name(name)
+{
+    skip();
+}
+
+XmlChildren::Iterator& XmlChildren::Iterator::operator++()
+{
+    assert(m_node != nullptr);
+    m_node = m_node->next;
+    skip();
+    return *this;
+}
+
+void XmlChildren::Iterator::skip()
+{
+    while (m_node != nullptr) {
+        if ((m_node->type == XML_ELEMENT_NODE) &&
+            ((m_name == nullptr) || (std::strcmp(reinterpret_cast<const char*>(m_node->name), m_name) == 0))) {
+            break;
+        }
+
+        m_node = m_node->next;
+    }
+}
+
+std::size_t XmlChildren::size() const
+{
+    std::size_t count = 0U;
+    for (auto iter = begin(); iter != end(); ++iter) {
+        ++count;
+    }
+    return count;
+}
+
 XmlPropsMap xmlParseNodeProps(xmlNodePtr node, xmlDocPtr doc)
 {
     assert(node != nullptr);
+    std::size_t count = 0U;
+    for (auto* prop = node->properties; prop != nullptr; prop = prop->next) {
+        ++count;
+    }
+
     XmlPropsMap map;
+    map.reserve(count);
     auto* prop = node->properties;
     while (prop != nullptr) {
         XmlCharPtr valuePtr(xmlNodeListGetString(doc, prop->children, 1));
-        map.insert(
-            std::make_pair(
-                reinterpret_cast<const char*>(prop->name),
-                reinterpret_cast<const char*>(valuePtr.get())));
+        std::string value;
+        if (valuePtr) {
+            value = reinterpret_cast<const char*>(valuePtr.get());
+        }
+
+        map.insert(reinterpret_cast<const char*>(prop->name), std::move(value));
         prop = prop->next;
     }
     return map;
@@ -53,31 +133,22 @@ std::string xmlText(xmlNodePtr node)
     return std::string();
 }
 
-std::list<xmlNodePtr> xmlChildren(xmlNodePtr node, const std::string& name)
+std::string xmlDump(xmlNodePtr node, xmlDocPtr doc)
 {
-    std::list<xmlNodePtr> result;
-    auto* cur = node->children;
-    while (cur != nullptr) {
-        do {
-            if (cur->type != XML_ELEMENT_NODE) {
-                break;
-            }
-
-            if (name.empty()) {
-                result.push_back(cur);
-                break;
-            }
+    assert(node != nullptr);
+    std::unique_ptr<xmlBuffer, decltype(&xmlBufferFree)> buf(xmlBufferCreate(), &xmlBufferFree);
+    if (!buf) {
+        return std::string();
+    }
 
-            std::string elemName(reinterpret_cast<const char*>(cur->name));
-            if (elemName == name) {
-                result.push_back(cur);
-                break;
-            }
-        } while (false);
+    xmlNodeDump(buf.get(), doc, node, 0, 0);
+    return std::string(reinterpret_cast<const char*>(xmlBufferContent(buf.get())));
+}
 
-        cur = cur->next;
-    }
-    return result;
+XmlChildren xmlChildren(xmlNodePtr node, const char* name)
+{
+    assert(node != nullptr);
+    return XmlChildren(node, name);
 }
 
 XmlNodePtr xmlCreatePadding(unsigned idx, unsigned len)
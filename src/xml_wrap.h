@@ -34,7 +34,7 @@ struct XmlDocFree
 {
     void operator()(::xmlDocPtr p) const
     {
-        xmlFree(p);
+        xmlFreeDoc(p);
     }
 };
 
@@ -56,14 +56,120 @@ struct XmlCharFree
 
 using XmlDocPtr = std::unique_ptr<xmlDoc, XmlDocFree>;
 using XmlCharPtr = std::unique_ptr<xmlChar, XmlCharFree>;
-using XmlPropsMap = std::map<std::string, std::string>;
 using XmlNodePtr = std::unique_ptr<xmlNode, XmlNodeFree>;
 using XmlEnumValue = std::pair<std::string, std::string>;
 using XmlEnumValuesList = std::vector<XmlEnumValue>;
 
+/// \brief Properties (attributes) of the XML node.
+/// \details Kept in a single vector sorted by name. Nodes have only a
+///     handful of properties, so the lookup is cheaper than with node based
+///     containers and the table requires only one allocation.
+class XmlPropsMap
+{
+public:
+    using value_type = std::pair<std::string, std::string>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    const_iterator begin() const
+    {
+        return m_props.begin();
+    }
+
+    const_iterator end() const
+    {
+        return m_props.end();
+    }
+
+    bool empty() const
+    {
+        return m_props.empty();
+    }
+
+    std::size_t size() const
+    {
+        return m_props.size();
+    }
+
+    void reserve(std::size_t count)
+    {
+        m_props.reserve(count);
+    }
+
+    const_iterator find(const std::string& name) const;
+    void insert(std::string name, std::string value);
+
+private:
+    std::vector<value_type> m_props;
+};
+
+/// \brief Range of element children of the XML node.
+/// \details Walks the sibling links of the node directly, optionally
+///     filtering by the element name, without collecting the children into
+///     a separate container.
+class XmlChildren
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(xmlNodePtr node, const char* name);
+
+        xmlNodePtr operator*() const
+        {
+            return m_node;
+        }
+
+        Iterator& operator++();
+
+        bool operator==(const Iterator& other) const
+        {
+            return m_node == other.m_node;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return m_node != other.m_node;
+        }
+
+    private:
+        void skip();
+
+        xmlNodePtr m_node = nullptr;
+        const char* m_name = nullptr;
+    };
+
+    XmlChildren(xmlNodePtr node, const char* name)
+      : m_node(node),
+        m_name(name)
+    {
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(m_node->children, m_name);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(nullptr, m_name);
+    }
+
+    bool empty() const
+    {
+        return begin() == end();
+    }
+
+    std::size_t size() const;
+
+private:
+    xmlNodePtr m_node = nullptr;
+    const char* m_name = nullptr;
+};
+
 XmlPropsMap xmlParseNodeProps(xmlNodePtr node, xmlDocPtr doc);
 std::string xmlText(xmlNodePtr node);
-std::list<xmlNodePtr> xmlChildren(xmlNodePtr node, const std::string& name = std::string());
+std::string xmlDump(xmlNodePtr node, xmlDocPtr doc);
+XmlChildren xmlChildren(xmlNodePtr node, const char* name = nullptr);
 XmlNodePtr xmlCreatePadding(unsigned idx, unsigned len);
 XmlNodePtr xmlCreateRawDataType(const std::string& name, unsigned len);
 XmlNodePtr xmlCreateBuiltInType(const std::string& name);
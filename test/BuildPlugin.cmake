@@ -1,11 +1,14 @@
 # PROJ_DIR
 # COMMS_INSTALL_DIR
 # CONFIG
+# UNITY_BUILD
+# USE_PCH
 
 set (build_dir "${PROJ_DIR}/build")
 file (MAKE_DIRECTORY ${build_dir})
 execute_process(
-    COMMAND ${CMAKE_COMMAND} -DOPT_FULL_SOLUTION=OFF -DOPT_CC_MAIN_INSTALL_DIR=${COMMS_INSTALL_DIR} ${PROJ_DIR}
+    COMMAND ${CMAKE_COMMAND} -DOPT_FULL_SOLUTION=OFF -DOPT_CC_MAIN_INSTALL_DIR=${COMMS_INSTALL_DIR}
+        -DOPT_UNITY_BUILD=${UNITY_BUILD} -DOPT_USE_PCH=${USE_PCH} ${PROJ_DIR}
     WORKING_DIRECTORY ${build_dir}
     RESULT_VARIABLE cmake_result
 )